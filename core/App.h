@@ -6,6 +6,13 @@
 #include "../graphics/Colors.h"
 #include "../graphics/Chars.h"
 #include "../graphics/Theme.h"
+#include "ThemeWatcher.h"
+#include "Wakeup.h"
+#include "KeyBindings.h"
+#include "TimerWheel.h"
+#include "FramePacer.h"
+#include "SessionRecorder.h"
+#include "ThreadPool.h"
 #include "../widgets/Widget.h"
 #include "../widgets/Window.h"
 #include "../widgets/Button.h"
@@ -20,13 +27,41 @@
 #include "../widgets/StatusBar.h"
 #include "../widgets/DropDown.h"
 #include "../widgets/MessageBox.h"
+#include "../widgets/LogView.h"
+#include "../widgets/DataGrid.h"
+#include "../widgets/Chart.h"
+#include "../widgets/Canvas.h"
+#include "../widgets/TreeView.h"
 #include <vector>
+#include <deque>
 #include <memory>
 #include <functional>
 #include <chrono>
+#include <algorithm>
+#include <future>
+#include <thread>
 
 namespace ui {
 
+/**
+ * @brief Метрики кадров главного цикла
+ */
+struct FrameStats {
+    uint64_t frames = 0;
+    uint64_t framesDrawn = 0;     // кадры с полной перерисовкой
+    uint64_t partialDraws = 0;    // кадры, где перерисованы только анимации
+    uint64_t timersFired = 0;
+    uint64_t outputDropped = 0;   // кадры, пропущенные писателем терминала
+    int outputQueueBytes = 0;     // очередь вывода терминала (TIOCOUTQ)
+    FramePacer::Decision pacing;  // текущее решение о частоте кадров
+    uint64_t framesDeferred = 0;  // кадры, отложенные из-за частоты
+    size_t inputDepth = 0;        // клавиш, забранных в последнем кадре
+    size_t maxInputDepth = 0;     // наибольшая очередь за всё время
+    uint64_t keysRead = 0;
+    uint64_t keysDispatched = 0;
+    uint64_t keysCoalesced = 0;   // повторы, слитые с предыдущей клавишей
+};
+
 /**
  * @brief Главное приложение TextUI
  * 
@@ -36,11 +71,18 @@ class App {
 private:
     Screen screen_;
     Input input_;
+    // Сигнал фоновых потоков (фильтр списка, индекс LogView, темы); объявлен
+    // раньше окон, чтобы пережить их потоки при разрушении App
+    Wakeup wakeup_;
     std::vector<std::unique_ptr<Window>> windows_;
     Window* focusedWindow_ = nullptr;
     StatusBar* statusBar_ = nullptr;
     ThemeManager themeManager_;
     Theme* currentTheme_;
+    ThemeId currentThemeId_ = kInvalidTheme;
+    ThemeWatcher themeWatcher_;
+    std::vector<ThemeUpdate> themeUpdates_;
+    std::string themeError_;
     bool running_ = false;
     bool useTheme_ = true;
     
@@ -48,14 +90,65 @@ private:
     std::chrono::steady_clock::time_point lastFrameTime_;
     int frameCount_ = 0;
     float fps_ = 0.0f;
+    FrameStats frameStats_;
+
+    // Назначения клавиш (аккорды, раскладки окон и типов виджетов)
+    KeyBindings keyBindings_;
+
+    // Конфликты горячих клавиш, найденные при регистрации
+    std::vector<HotkeyConflict> hotkeyConflicts_;
+
+    // Стек модальных диалогов: клавиши получает верхний,
+    // рисуются поверх окон в порядке открытия
+    std::vector<std::unique_ptr<ui::MessageBox>> modalStack_;
 
-    // Callback для глобальных горячих клавиш
-    std::function<bool(Key)> globalHotkeyHandler_;
+    // Клавиши пачки, ещё не отданные processKey: блокирующий MessageBox
+    // из обработчика крутит вложенные кадры, и остаток пачки достаётся им
+    std::deque<Key> pendingKeys_;
+
+    // Области закрытых диалогов, которые нужно стереть при отрисовке
+    struct ClosedArea { int x, y, width, height; };
+    std::vector<ClosedArea> closedModalAreas_;
+
+    // Виджеты с фоновой работой: проверяются в кадре после wakeup_
+    struct AsyncWatch {
+        Window* window;
+        Widget* widget;
+        std::function<bool()> changed;
+    };
+    std::vector<AsyncWatch> asyncWatches_;
+
+    // Таймеры; кадр рисуется, только когда что-то изменилось
+    TimerWheel timers_;
+    bool redrawAll_ = true;
+    std::vector<Widget*> dirtyWidgets_;
+
+    // Частота кадров по скорости терминала
+    FramePacer pacer_;
+    bool pacing_ = true;
+    std::chrono::steady_clock::time_point lastOutputTime_;
+
+    // Запись сессии (кадры с экрана)
+    SessionRecorder recorder_;
+
+    // Параллельная отрисовка окон: слой на окно, размером с экран
+    bool parallelDraw_ = false;
+    std::vector<std::unique_ptr<Screen>> layers_;
+    std::vector<Window*> drawOrder_;
+    std::vector<Screen*> windowLayers_;   // nullptr - окно рисуется в потоке интерфейса
 
 public:
+    static constexpr int kMaxIdleMs = 1000;   // наибольшее ожидание ввода в кадре
+    static constexpr size_t kMaxKeysPerFrame = 256;
+
     App() : currentTheme_(nullptr) {
         // По умолчанию используем BIOS тему
-        currentTheme_ = themeManager_.getTheme("bios");
+        currentThemeId_ = themeManager_.findTheme("bios");
+        currentTheme_ = themeManager_.getTheme(currentThemeId_);
+        setupKeyBindings();
+        input_.setWakeup(&wakeup_);
+        input_.setControlOutput([this](const char* sequence) { screen_.sendControl(sequence); });
+        themeWatcher_.setOnUpdate(wakeupNotifier());
     }
     
     ~App() { 
@@ -66,8 +159,28 @@ public:
     bool init() {
         if (!screen_.init()) return false;
         if (!input_.init()) return false;
+        input_.setKittyKeyboard(screen_.getTerminalFeatures().kittyKeyboard);
+        return prepareScreen();
+    }
+
+#ifndef _WIN32
+    /**
+     * @brief Инициализация без терминала
+     *
+     * Экран width x height только собирает кадры, клавиши читаются
+     * из inputFd. Главный цикл крутит вызывающий (runFrame), см.
+     * InputReplay.
+     */
+    bool initHeadless(int width, int height, int inputFd) {
+        if (!screen_.initHeadless(width, height)) return false;
+        if (!input_.initHeadless(inputFd)) return false;
+        return prepareScreen();
+    }
+#endif
 
-        screen_.clear();
+    // Начальное состояние экрана после инициализации
+    bool prepareScreen() {
+        screen_.clear(ThemeRole::ScreenBackground);
         screen_.showCursor(false);
 
         // Применяем текущую тему
@@ -81,20 +194,66 @@ public:
 
     // Завершение
     void shutdown() {
+        stopRecording();
+        themeWatcher_.stop();
         screen_.shutdown();
         input_.shutdown();
     }
 
-    // Применение темы
+    // Применение темы: меняется только палитра ролей, ячейки
+    // перекодируются при следующем выводе без перерисовки виджетов
     void applyTheme(const Theme& theme) {
         currentTheme_ = const_cast<Theme*>(&theme);
-        screen_.clear(theme.getScreenBackground());
+        currentThemeId_ = kInvalidTheme;
+        for (ThemeId id = 0; id < themeManager_.getThemeCount(); id++) {
+            if (themeManager_.getTheme(id) == &theme) {
+                applyTheme(id);
+                return;
+            }
+        }
+        screen_.setPalette(theme.toPalette());
+    }
+
+    // Тема из менеджера: палитра уже скомпилирована
+    void applyTheme(ThemeId id) {
+        Theme* theme = themeManager_.getTheme(id);
+        if (!theme) return;
+        currentTheme_ = theme;
+        currentThemeId_ = id;
+        screen_.setPalette(themeManager_.getPalette(id));
     }
 
     void setTheme(const std::string& themeName) {
-        Theme* theme = themeManager_.getTheme(themeName);
-        if (theme) {
-            applyTheme(*theme);
+        applyTheme(themeManager_.findTheme(themeName));
+    }
+
+    /**
+     * @brief Загружать темы из каталога и следить за изменениями
+     *
+     * Файлы <имя>.theme регистрируются в ThemeManager под своим
+     * именем; изменение файла текущей темы применяется сразу.
+     * Файл с ошибкой игнорируется (см. getThemeError()), прежняя
+     * версия темы остаётся в силе.
+     */
+    bool watchThemes(const std::string& dir) {
+        return themeWatcher_.start(dir);
+    }
+
+    void stopWatchingThemes() { themeWatcher_.stop(); }
+
+    // Последняя ошибка загрузки файла темы (пусто - ошибок не было)
+    const std::string& getThemeError() const { return themeError_; }
+
+    // Забрать перезагруженные темы (вызывается в каждом кадре)
+    void pollThemes() {
+        if (!themeWatcher_.poll(themeUpdates_)) return;
+        for (ThemeUpdate& update : themeUpdates_) {
+            if (!update.ok) {
+                themeError_ = update.error;
+                continue;
+            }
+            ThemeId id = themeManager_.addTheme(update.name, update.theme);
+            if (id == currentThemeId_) applyTheme(id);
         }
     }
 
@@ -105,6 +264,9 @@ public:
     Window* createWindow(int x, int y, int w, int h, const std::string& title = "") {
         auto window = std::make_unique<Window>(x, y, w, h, title);
         Window* ptr = window.get();
+        ptr->setOnHotkeyConflict([this](const HotkeyConflict& conflict) {
+            hotkeyConflicts_.push_back(conflict);
+        });
         windows_.push_back(std::move(window));
         focusedWindow_ = ptr;
         return ptr;
@@ -164,7 +326,10 @@ public:
 
     ListBox* addListBox(Window* window, int x, int y, int w, int h) {
         if (!window) return nullptr;
-        return window->addChild<ListBox>(x, y, w, h);
+        ListBox* list = window->addChild<ListBox>(x, y, w, h);
+        list->setOnFilterReady(wakeupNotifier());
+        watchChild(window, list, [list] { return list->pollFilter(); });
+        return list;
     }
 
     Menu* addMenu(Window* window, int x, int y, int width) {
@@ -179,7 +344,42 @@ public:
 
     DropDown* addDropDown(Window* window, int x, int y, int w) {
         if (!window) return nullptr;
-        return window->addChild<DropDown>(x, y, w);
+        DropDown* dropDown = window->addChild<DropDown>(x, y, w);
+        dropDown->setOnFilterReady(wakeupNotifier());
+        watchChild(window, dropDown, [dropDown] { return dropDown->pollFilter(); });
+        return dropDown;
+    }
+
+    LogView* addLogView(Window* window, int x, int y, int w, int h, const std::string& path = "") {
+        if (!window) return nullptr;
+        LogView* view = window->addChild<LogView>(x, y, w, h);
+        view->setOnChange(wakeupNotifier());
+        if (!path.empty()) view->open(path);
+        watchChild(window, view, [view] { return view->changed(); });
+        return view;
+    }
+
+    // Создание таблицы
+    DataGrid* addDataGrid(Window* window, int x, int y, int w, int h) {
+        if (!window) return nullptr;
+        return window->addChild<DataGrid>(x, y, w, h);
+    }
+
+    // График потока отсчётов (см. watch)
+    Chart* addChart(Window* window, int x, int y, int w, int h) {
+        if (!window) return nullptr;
+        return window->addChild<Chart>(x, y, w, h);
+    }
+
+    // Холст w x h ячеек, 2x4 точки в ячейке
+    Canvas* addCanvas(Window* window, int x, int y, int w, int h) {
+        if (!window) return nullptr;
+        return window->addChild<Canvas>(x, y, w, h);
+    }
+
+    TreeView* addTreeView(Window* window, int x, int y, int w, int h) {
+        if (!window) return nullptr;
+        return window->addChild<TreeView>(x, y, w, h);
     }
 
     // Создание строки состояния
@@ -189,34 +389,71 @@ public:
         return statusBar_;
     }
 
-    // Показать MessageBox
+    /**
+     * @brief Показать MessageBox, не останавливая главный цикл
+     *
+     * Диалог становится верхним в стеке модальных: получает все
+     * клавиши, пока не закроется, а окна под ним продолжают
+     * обновляться и перерисовываться. onResult вызывается при
+     * выборе кнопки. Указатель действителен до закрытия диалога.
+     */
+    ui::MessageBox* showMessageBox(const std::string& title, const std::string& message,
+                                   MessageBoxIcon icon = MessageBoxIcon::None,
+                                   MessageBoxButtons buttons = MessageBoxButtons::OK,
+                                   std::function<void(MessageBoxResult)> onResult = nullptr) {
+        auto box = std::make_unique<ui::MessageBox>(
+            ui::MessageBox::createCentered(screen_, title, message, icon, buttons));
+        box->setOnResult(std::move(onResult));
+        box->setVisible(true);
+        modalStack_.push_back(std::move(box));
+        redrawAll_ = true;
+        return modalStack_.back().get();
+    }
+
+    // То же, результат - через future (готов после закрытия диалога)
+    std::future<MessageBoxResult> showMessageBoxAsync(const std::string& title, const std::string& message,
+                                                      MessageBoxIcon icon = MessageBoxIcon::None,
+                                                      MessageBoxButtons buttons = MessageBoxButtons::OK) {
+        auto promise = std::make_shared<std::promise<MessageBoxResult>>();
+        std::future<MessageBoxResult> result = promise->get_future();
+        showMessageBox(title, message, icon, buttons,
+                       [promise](MessageBoxResult r) { promise->set_value(r); });
+        return result;
+    }
+
+    /**
+     * @brief Показать MessageBox и дождаться ответа
+     *
+     * Ждёт во вложенных кадрах главного цикла (runFrame), поэтому
+     * остальной интерфейс продолжает обновляться. Вызов из обработчика
+     * клавиши допустим; в новом коде удобнее showMessageBox.
+     */
     MessageBoxResult MessageBox(const std::string& title, const std::string& message,
                                 MessageBoxIcon icon = MessageBoxIcon::None,
                                 MessageBoxButtons buttons = MessageBoxButtons::OK) {
-        auto msgBox = MessageBox::createCentered(screen_, title, message, icon, buttons);
-        msgBox.setVisible(true);
-        
-        // Временно добавляем как окно
-        auto window = std::make_unique<Window>(msgBox.x(), msgBox.y(), msgBox.width(), msgBox.height(), title);
-        window->setModal(true);
-        window->setVisible(true);
-        
-        // Блокирующий цикл для MessageBox
-        input_.enableRawMode();
-        while (msgBox.visible()) {
-            msgBox.draw(screen_);
-            screen_.flush();
-            
-            Key key = input_.readKey();
-            if (key != Key::None) {
-                msgBox.handleKey(key);
-            }
+        auto answer = std::make_shared<std::pair<bool, MessageBoxResult>>(false, MessageBoxResult::None);
+        showMessageBox(title, message, icon, buttons, [answer](MessageBoxResult r) {
+            answer->first = true;
+            answer->second = r;
+        });
+
+        bool wasRaw = input_.isRawModeEnabled();
+        if (!wasRaw) input_.enableRawMode();
+        while (!answer->first) {
+            runFrame();
         }
-        input_.disableRawMode();
-        
-        return msgBox.getResult();
+        if (!wasRaw) input_.disableRawMode();
+
+        return answer->second;
     }
 
+    // Верхний модальный диалог (nullptr - диалогов нет)
+    ui::MessageBox* getTopModal() const {
+        return modalStack_.empty() ? nullptr : modalStack_.back().get();
+    }
+
+    size_t getModalCount() const { return modalStack_.size(); }
+
     // Выход
     void exit() {
         running_ = false;
@@ -229,9 +466,64 @@ public:
     Window* getFocusedWindow() const { return focusedWindow_; }
     StatusBar* getStatusBar() const { return statusBar_; }
 
-    // Установка глобального обработчика горячих клавиш
+    // Глобальный обработчик клавиш - верхний слой KeyBindings
     void setGlobalHotkeyHandler(std::function<bool(Key)> handler) {
-        globalHotkeyHandler_ = handler;
+        keyBindings_.setHandler(std::move(handler));
+    }
+
+    KeyBindings& getKeyBindings() { return keyBindings_; }
+
+    // Загрузить назначения клавиш из файла (см. KeyBindings::loadConfig)
+    bool loadKeyBindings(const std::string& path, std::string& error) {
+        return keyBindings_.loadFile(path, error);
+    }
+
+    /**
+     * @brief Обработка одной клавиши
+     *
+     * Порядок: обработчик и раскладки KeyBindings, StatusBar,
+     * горячие клавиши, активное окно. Виджет с текстовым вводом
+     * получает символы, Backspace/Delete и Escape раньше раскладок,
+     * чтобы они не перехватывались назначениями.
+     */
+    bool processKey(Key key) {
+        // Открытый диалог забирает клавиши у окон и раскладок;
+        // выше него только обработчик приложения
+        if (!modalStack_.empty()) {
+            if (keyBindings_.handleHandler(key)) return true;
+            modalStack_.back()->handleKey(key);
+            return true;
+        }
+
+        KeyBindings::Context context = keyContext();
+
+        if (isTextInputKey(key) && !keyBindings_.isChordPending() &&
+            focusedWindow_ && focusedWindow_->wantsTextInput()) {
+            if (keyBindings_.handleHandler(key)) return true;
+            if (focusedWindow_->handleKey(key)) return true;
+            if (keyBindings_.handleKeymaps(key, context)) return true;
+        } else if (keyBindings_.handleKey(key, context)) {
+            return true;
+        }
+
+        // F-клавиши для StatusBar
+        if (statusBar_ && key >= Key::F1 && key <= Key::F12) {
+            if (statusBar_->handleKey(key)) {
+                return true;
+            }
+        }
+
+        // Обработка хоткеев (буквы)
+        Key baseKey = getBaseKey(key);
+        if (baseKey >= Key::A && baseKey <= Key::Z) {
+            char hotkey = static_cast<char>(static_cast<int>(baseKey));
+            if (dispatchHotkey(hotkey)) {
+                return true;
+            }
+        }
+
+        // Передача ввода активному окну
+        return focusedWindow_ && focusedWindow_->handleKey(key);
     }
 
     // Переключение фокуса между окнами
@@ -260,7 +552,7 @@ public:
     void run() {
         if (!running_) {
             running_ = true;
-            screen_.clear();
+            screen_.clear(ThemeRole::ScreenBackground);
             screen_.showCursor(false);
             input_.enableRawMode();
             
@@ -276,86 +568,450 @@ public:
         }
 
         while (running_) {
-            // Обработка ввода
-            Key key = input_.readKey();
-            
+            runFrame();
+        }
+
+        input_.disableRawMode();
+    }
+
+    /**
+     * @brief Один кадр главного цикла
+     *
+     * Спит до клавиши или ближайшего срока (таймер, аккорд), забирает
+     * всё, что успело накопиться, обрабатывает клавиши по порядку,
+     * выполняет наступившие таймеры, закрывает отработавшие диалоги,
+     * подхватывает темы и рисует не больше одного кадра: целиком
+     * после ввода и обычных таймеров, только свои виджеты - после
+     * анимаций, ничего - если ничего не изменилось.
+     */
+    void runFrame() {
+        // Остаток пачки от внешнего кадра (вложенный кадр блокирующего
+        // MessageBox) обрабатывается раньше нового ввода
+        if (!pendingKeys_.empty()) {
+            dispatchPendingKeys();
+            redrawAll_ = true;
+        } else {
+            std::vector<Key> keys;
+            Key key = input_.waitKey(waitTimeoutMs());
             if (key != Key::None) {
-                // Глобальные горячие клавиши
-                if (globalHotkeyHandler_ && globalHotkeyHandler_(key)) {
-                    continue;
-                }
+                keys.push_back(key);
+                input_.drainKeys(keys, kMaxKeysPerFrame - 1);
+                processKeys(keys);
+                redrawAll_ = true;
+            }
+        }
+        if (keyBindings_.update()) redrawAll_ = true;
+        frameStats_.timersFired += timers_.advance();
+        closeFinishedModals();
+        if (wakeup_.consume()) pollAsyncWatches();
+        pollThemes();
 
-                // Выход по Q или Escape (если нет модальных окон)
-                if ((key == Key::Q || key == Key::Escape) && !hasModalWindow()) {
-                    exit();
-                    continue;
-                }
+        // Отрисовка не чаще, чем позволяет терминал; изменения
+        // до следующего разрешённого кадра копятся
+        frameStats_.frames++;
+        auto now = std::chrono::steady_clock::now();
+        bool pending = hasPendingFrame();
+        if (pending && now < nextOutputTime()) {
+            frameStats_.framesDeferred++;
+        } else if (redrawAll_) {
+            draw();
+            frameStats_.framesDrawn++;
+            frameCount_++;
+            lastOutputTime_ = now;
+        } else if (!dirtyWidgets_.empty()) {
+            drawInvalidated();
+            frameCount_++;
+            lastOutputTime_ = now;
+        } else {
+            screen_.flush();   // смена палитры без перерисовки
+        }
+        updatePacing();
 
-                // Tab - переключение фокуса между виджетами
-                if (key == Key::Tab && focusedWindow_) {
-                    focusedWindow_->focusNext();
-                    continue;
-                }
+        // Подсчёт FPS
+        auto elapsed = std::chrono::duration<float>(now - lastFrameTime_).count();
+        if (elapsed >= 1.0f) {
+            fps_ = frameCount_ / elapsed;
+            frameCount_ = 0;
+            lastFrameTime_ = now;
+        }
+    }
 
-                // F-клавиши для StatusBar
-                if (statusBar_ && key >= Key::F1 && key <= Key::F12) {
-                    if (statusBar_->handleKey(key)) {
-                        continue;
-                    }
-                }
+    /**
+     * @brief Обработать пачку клавиш, пришедших за один кадр
+     *
+     * Повтор Home/End подряд ничего не меняет, поэтому такие
+     * повторы сливаются с первой клавишей. Стрелки и PageUp/PageDown
+     * обрабатываются все: каждое нажатие сдвигает курсор.
+     * Клавиши идут через pendingKeys_: открытый из обработчика
+     * блокирующий MessageBox получает остаток пачки.
+     */
+    void processKeys(const std::vector<Key>& keys) {
+        frameStats_.inputDepth = keys.size();
+        if (keys.size() > frameStats_.maxInputDepth) frameStats_.maxInputDepth = keys.size();
+        frameStats_.keysRead += keys.size();
 
-                // Обработка хоткеев (буквы)
-                Key baseKey = getBaseKey(key);
-                if (baseKey >= Key::A && baseKey <= Key::Z) {
-                    char hotkey = static_cast<char>(static_cast<int>(baseKey));
-                    // Сначала активному окну
-                    if (focusedWindow_ && focusedWindow_->handleHotkey(hotkey)) {
-                        continue;
-                    }
-                    // Потом всем окнам
-                    for (auto& window : windows_) {
-                        if (window->visible() && window->handleHotkey(hotkey)) {
-                            break;
-                        }
-                    }
-                }
+        pendingKeys_.insert(pendingKeys_.end(), keys.begin(), keys.end());
+        dispatchPendingKeys();
+    }
 
-                // Передача ввода активному окну
-                if (focusedWindow_ && focusedWindow_->handleKey(key)) {
-                    continue;
-                }
+    static bool isIdempotentKey(Key key) {
+        return key == Key::Home || key == Key::End;
+    }
+
+    const FrameStats& getFrameStats() const { return frameStats_; }
+
+    /**
+     * @brief Записывать выведенные кадры в файл (см. SessionRecorder)
+     * Воспроизведение - SessionPlayer.
+     */
+    bool startRecording(const std::string& path) {
+        screen_.setFrameObserver(nullptr);
+        if (!recorder_.start(path)) return false;
+        screen_.setFrameObserver(&recorder_);
+        return true;
+    }
+
+    void stopRecording() {
+        if (screen_.getFrameObserver() == &recorder_) screen_.setFrameObserver(nullptr);
+        recorder_.stop();
+    }
+
+    SessionRecorder::Stats getRecordingStats() const { return recorder_.getStats(); }
+
+    // Вывод в терминал из отдельного потока (см. Screen::setAsyncOutput)
+    void setAsyncOutput(bool enable) { screen_.setAsyncOutput(enable); }
+
+    // Таймеры (срабатывают в главном цикле, поток интерфейса)
+
+    // Однократный таймер; после срабатывания экран перерисовывается
+    TimerId setTimeout(int delayMs, std::function<void()> callback) {
+        return timers_.setTimeout(delayMs, [this, callback]() {
+            callback();
+            redrawAll_ = true;
+        });
+    }
+
+    // Повторяющийся таймер; после каждого срабатывания экран перерисовывается
+    TimerId setInterval(int intervalMs, std::function<void()> callback) {
+        return timers_.setInterval(intervalMs, [this, callback]() {
+            callback();
+            redrawAll_ = true;
+        });
+    }
+
+    /**
+     * @brief Анимация виджета
+     *
+     * step получает номер кадра (0, 1, 2...) и меняет состояние
+     * виджета; после шага перерисовывается только этот виджет.
+     * Таймер нужно снять cancelTimer до удаления виджета.
+     *
+     *     app.animate(bar, 100, [bar](int frame) { bar->setAnimationFrame(frame); });
+     */
+    TimerId animate(Widget* widget, int intervalMs, std::function<void(int)> step) {
+        auto frame = std::make_shared<int>(0);
+        return timers_.setInterval(intervalMs, [this, widget, frame, step]() {
+            step((*frame)++);
+            invalidate(widget);
+        });
+    }
+
+    /**
+     * @brief Опрос виджета с данными из других потоков
+     *
+     * changed() вызывается каждые intervalMs в потоке интерфейса;
+     * виджет перерисовывается, только если она вернула true.
+     * Таймер нужно снять cancelTimer до удаления виджета.
+     *
+     *     app.watch(chart, 50, [chart] { return chart->update(); });
+     */
+    TimerId watch(Widget* widget, int intervalMs, std::function<bool()> changed) {
+        return timers_.setInterval(intervalMs, [this, widget, changed]() {
+            if (changed()) invalidate(widget);
+        });
+    }
+
+    /**
+     * @brief Проверка виджета окна, созданного addX, после сигнала его потока
+     *
+     * Фоновые результаты (фильтр списка, индекс LogView) виджет
+     * забирает сам только в draw/handleKey; без проверки они ждали бы
+     * нажатия клавиши. Поток виджета будит цикл через wakeupNotifier(),
+     * и changed() вызывается только в таком кадре - между сигналами
+     * цикл спит. Запись снимается сама, когда виджет удалён из окна.
+     */
+    void watchChild(Window* window, Widget* widget, std::function<bool()> changed) {
+        asyncWatches_.push_back(AsyncWatch{window, widget, std::move(changed)});
+    }
+
+    // Будит главный цикл из любого потока: для setOnFilterReady, setOnChange и т.п.
+    std::function<void()> wakeupNotifier() {
+        return [this] { wakeup_.notify(); };
+    }
+
+    bool cancelTimer(TimerId id) { return timers_.cancel(id); }
+    bool isTimerActive(TimerId id) const { return timers_.isActive(id); }
+
+    // Перерисовать всё в следующем кадре
+    void invalidate() { redrawAll_ = true; }
+
+    // Перерисовать один виджет в следующем кадре
+    void invalidate(Widget* widget) {
+        if (std::find(dirtyWidgets_.begin(), dirtyWidgets_.end(), widget) == dirtyWidgets_.end()) {
+            dirtyWidgets_.push_back(widget);
+        }
+    }
+
+    // Ожидание ввода до ближайшего срока
+    int waitTimeoutMs() const {
+        auto deadline = timers_.nextDeadline();
+        if (keyBindings_.isChordPending() && keyBindings_.getChordDeadline() < deadline) {
+            deadline = keyBindings_.getChordDeadline();
+        }
+        // Отложенный кадр
+        if (hasPendingFrame() && nextOutputTime() < deadline) {
+            deadline = nextOutputTime();
+        }
+
+        // Фоновые потоки (темы, фильтры, LogView) будят ожидание сами
+        int timeout = kMaxIdleMs;
+        if (deadline == TimerWheel::Clock::time_point::max()) return timeout;
+
+        auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - TimerWheel::Clock::now()).count();
+        if (left < 0) return 0;
+        // +1: колесо считает целые миллисекунды, не просыпаемся раньше тика
+        if (left + 1 < timeout) timeout = static_cast<int>(left + 1);
+        return timeout;
+    }
+
+    // Есть изменения, ещё не выведенные на экран
+    bool hasPendingFrame() const { return redrawAll_ || !dirtyWidgets_.empty(); }
+
+    /**
+     * @brief Ограничивать частоту кадров (по умолчанию включено)
+     * Выключенное - каждый кадр выводится сразу (прогоны без терминала).
+     */
+    void setPacing(bool enable) {
+        pacing_ = enable;
+        pacer_.reset();
+        screen_.setGapLimit(0);
+    }
+
+    bool isPacing() const { return pacing_; }
+
+    /**
+     * @brief Рисовать окна параллельно (по умолчанию выключено)
+     *
+     * При полной перерисовке окна, все виджеты которых разрешают
+     * это (Widget::canDrawConcurrently), рисуются на ThreadPool::shared(),
+     * каждое в свой слой; затем слои накладываются на экран в порядке
+     * окон. Остальные окна, строка состояния и диалоги рисуются в
+     * потоке интерфейса. Выигрыш - на больших экранах с многими окнами;
+     * на одном ядре слои только мешают, и режим ничего не делает.
+     */
+    void setParallelDraw(bool enable) {
+        parallelDraw_ = enable;
+        if (!enable) layers_.clear();
+    }
+
+    bool isParallelDraw() const { return parallelDraw_; }
+
+    // Раньше этого момента новый кадр не выводится
+    std::chrono::steady_clock::time_point nextOutputTime() const {
+        if (!pacing_) return lastOutputTime_;
+        return lastOutputTime_ + std::chrono::milliseconds(pacer_.decision().minFrameMs);
+    }
+
+    // Учесть вывод кадра и применить решение о частоте и гранулярности
+    void updatePacing() {
+        TerminalWriter::Stats output = screen_.getOutputStats();
+        frameStats_.outputDropped = output.dropped;
+        frameStats_.outputQueueBytes = output.queuedBytes;
+        if (!pacing_) return;
+        pacer_.sample(output, screen_.queuedOutputBytes());
+        const FramePacer::Decision& decision = pacer_.decision();
+        if (decision.gapLimit != screen_.getGapLimit()) {
+            screen_.setGapLimit(decision.gapLimit);
+        }
+        frameStats_.pacing = decision;
+    }
+
+    /**
+     * @brief Отдать processKey клавиши из pendingKeys_
+     *
+     * Клавиша снимается с очереди до обработки, поэтому вложенный кадр
+     * продолжает со следующей. На закрытом диалоге пачка прерывается:
+     * блокирующий MessageBox должен вернуться раньше, чем остальные
+     * клавиши уйдут окну под ним.
+     */
+    void dispatchPendingKeys() {
+        Key previous = Key::None;
+        while (!pendingKeys_.empty()) {
+            Key key = pendingKeys_.front();
+            pendingKeys_.pop_front();
+            if (key == previous && isIdempotentKey(key) && !keyBindings_.isChordPending()) {
+                frameStats_.keysCoalesced++;
+                continue;
             }
+            bool modal = !modalStack_.empty();
+            processKey(key);
+            frameStats_.keysDispatched++;
+            previous = key;
+            if (modal && hasFinishedModal()) break;
+        }
+    }
 
-            // Отрисовка
-            draw();
+    bool hasFinishedModal() const {
+        for (const auto& modal : modalStack_) {
+            if (!modal->visible()) return true;
+        }
+        return false;
+    }
 
-            // Подсчёт FPS
-            frameCount_++;
-            auto now = std::chrono::steady_clock::now();
-            auto elapsed = std::chrono::duration<float>(now - lastFrameTime_).count();
-            if (elapsed >= 1.0f) {
-                fps_ = frameCount_ / elapsed;
-                frameCount_ = 0;
-                lastFrameTime_ = now;
+    // Забрать фоновые результаты виджетов watchChild
+    void pollAsyncWatches() {
+        for (size_t i = 0; i < asyncWatches_.size();) {
+            AsyncWatch& watch = asyncWatches_[i];
+            if (!watch.window->hasChild(watch.widget)) {
+                asyncWatches_.erase(asyncWatches_.begin() + static_cast<std::ptrdiff_t>(i));
+                continue;
             }
+            if (watch.changed()) invalidate(watch.widget);
+            i++;
+        }
+    }
 
-            // Задержка ~30 FPS
-#ifdef _WIN32
-            Sleep(33);
-#else
-            usleep(33000);
-#endif
+    // Убрать из стека закрытые диалоги (в любой его позиции)
+    void closeFinishedModals() {
+        for (auto it = modalStack_.begin(); it != modalStack_.end();) {
+            if ((*it)->visible()) {
+                ++it;
+                continue;
+            }
+            closedModalAreas_.push_back({(*it)->x(), (*it)->y(), (*it)->width(), (*it)->height()});
+            it = modalStack_.erase(it);
+            redrawAll_ = true;
         }
+    }
 
-        input_.disableRawMode();
+    /**
+     * @brief Перерисовать только изменившиеся виджеты
+     *
+     * Виджет рисуется отдельно, если поверх него ничего нет: он
+     * лежит в окне, которое не перекрыто следующими окнами, строкой
+     * состояния и диалогами. Иначе - полная перерисовка.
+     */
+    void drawInvalidated() {
+        for (Widget* widget : dirtyWidgets_) {
+            if (!canDrawAlone(widget)) {
+                draw();
+                return;
+            }
+        }
+        for (Widget* widget : dirtyWidgets_) {
+            widget->drawChanges(screen_);
+        }
+        dirtyWidgets_.clear();
+        frameStats_.partialDraws++;
+        screen_.flush();
+    }
+
+    bool canDrawAlone(const Widget* widget) const {
+        if (!modalStack_.empty()) return false;
+        if (widget == statusBar_) return statusBar_->visible();
+
+        size_t owner = windows_.size();
+        for (size_t i = 0; i < windows_.size(); i++) {
+            if (windows_[i]->hasChild(widget)) {
+                owner = i;
+                break;
+            }
+        }
+        // Виджет не в окне (например, на вкладке) или уже удалён
+        if (owner == windows_.size()) return false;
+        if (!windows_[owner]->visible() || !widget->visible()) return false;
+
+        for (size_t i = owner + 1; i < windows_.size(); i++) {
+            if (windows_[i]->visible() && overlaps(*widget, *windows_[i])) return false;
+        }
+        return !(statusBar_ && statusBar_->visible() && overlaps(*widget, *statusBar_));
+    }
+
+    /**
+     * @brief Отрисовка окон в слоях на пуле потоков
+     * @return false - одно ядро или меньше двух окон можно рисовать
+     *         параллельно; тогда окна рисуются как обычно
+     */
+    bool drawWindowsParallel() {
+        if (std::thread::hardware_concurrency() < 2) return false;
+        drawOrder_.clear();
+        windowLayers_.clear();
+        size_t parallel = 0;
+        for (auto& window : windows_) {
+            if (!window->visible()) continue;
+            drawOrder_.push_back(window.get());
+            bool concurrent = window->canDrawConcurrently();
+            windowLayers_.push_back(concurrent ? layerFor(parallel) : nullptr);
+            if (concurrent) parallel++;
+        }
+        if (parallel < 2) return false;
+
+        ThreadPool::shared().parallelEach(drawOrder_.size(), [this](size_t i) {
+            Screen* layer = windowLayers_[i];
+            if (!layer) return;
+            Window* window = drawOrder_[i];
+            layer->fillRect(window->x(), window->y(), window->width(), window->height(),
+                            Screen::kTransparent, StyleId{});
+            window->draw(*layer);
+        });
+
+        // Наложение в порядке окон: верхнее закрывает нижние
+        for (size_t i = 0; i < drawOrder_.size(); i++) {
+            Window* window = drawOrder_[i];
+            if (Screen* layer = windowLayers_[i]) {
+                screen_.composite(*layer, window->x(), window->y(), window->width(), window->height());
+            } else {
+                window->draw(screen_);
+            }
+        }
+        return true;
+    }
+
+    // Слой n размером с экран (создаётся и пересоздаётся по размеру)
+    Screen* layerFor(size_t n) {
+        if (layers_.size() <= n) layers_.resize(n + 1);
+        std::unique_ptr<Screen>& layer = layers_[n];
+        if (!layer || layer->getWidth() != screen_.getWidth() ||
+            layer->getHeight() != screen_.getHeight()) {
+            layer = std::make_unique<Screen>();
+            layer->initHeadless(screen_.getWidth(), screen_.getHeight());
+        }
+        return layer.get();
+    }
+
+    static bool overlaps(const Widget& a, const Widget& b) {
+        return a.x() < b.x() + b.width() && b.x() < a.x() + a.width() &&
+               a.y() < b.y() + b.height() && b.y() < a.y() + a.height();
     }
 
     // Принудительная отрисовка
     void draw() {
+        redrawAll_ = false;
+        dirtyWidgets_.clear();
+
+        // Место закрытых диалогов - фон; окна перерисуются поверх
+        for (const ClosedArea& area : closedModalAreas_) {
+            screen_.fillRect(area.x, area.y, area.width, area.height, ' ', ThemeRole::ScreenBackground);
+        }
+        closedModalAreas_.clear();
+
         // Отрисовка всех окон
-        for (auto& window : windows_) {
-            if (window->visible()) {
-                window->draw(screen_);
+        if (!parallelDraw_ || !drawWindowsParallel()) {
+            for (auto& window : windows_) {
+                if (window->visible()) {
+                    window->draw(screen_);
+                }
             }
         }
 
@@ -364,12 +1020,118 @@ public:
             statusBar_->draw(screen_);
         }
 
+        // Диалоги поверх всего
+        for (auto& modal : modalStack_) {
+            modal->draw(screen_);
+        }
+
         // Отправляем изменения на экран
         screen_.flush();
     }
 
+    /**
+     * @brief Передать горячую клавишу окнам
+     *
+     * Видимое модальное окно (последнее созданное) получает клавишу
+     * единственным. Иначе - сначала активное окно, затем остальные.
+     * Внутри окна поиск идёт по таблице клавиш, без обхода виджетов.
+     */
+    bool dispatchHotkey(char hotkey) {
+        if (Window* modal = topModalWindow()) {
+            return modal->handleHotkey(hotkey);
+        }
+        if (focusedWindow_ && focusedWindow_->handleHotkey(hotkey)) {
+            return true;
+        }
+        for (auto& window : windows_) {
+            if (window.get() != focusedWindow_ && window->visible() &&
+                window->handleHotkey(hotkey)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Конфликты горячих клавиш (клавиша осталась за первым виджетом)
+    const std::vector<HotkeyConflict>& getHotkeyConflicts() const { return hotkeyConflicts_; }
+
+    // Верхнее видимое модальное окно
+    Window* topModalWindow() const {
+        for (auto it = windows_.rbegin(); it != windows_.rend(); ++it) {
+            if ((*it)->visible() && (*it)->isModal()) return it->get();
+        }
+        return nullptr;
+    }
+
+    // Клавиши, которые виджет с текстовым вводом получает первым
+    static bool isTextInputKey(Key key) {
+        if (hasCtrl(key) || hasAlt(key)) return false;
+        Key base = getBaseKey(key);
+        return (base >= Key::Space && static_cast<int>(base) < 127) ||
+               base == Key::Backspace || base == Key::Delete || base == Key::Escape;
+    }
+
+    // Контекст фокуса для раскладок
+    KeyBindings::Context keyContext() const {
+        KeyBindings::Context context;
+        if (focusedWindow_) {
+            context.window = &focusedWindow_->getTitle();
+            if (Widget* child = focusedWindow_->getFocusedChild()) {
+                context.widget = std::type_index(typeid(*child));
+            }
+        }
+        return context;
+    }
+
+    /**
+     * @brief Стандартные действия и назначения
+     *
+     * app.quit (q, Escape), focus.next (Tab), focus.prev, window.next.
+     * Назначения меняются через getKeyBindings() или файл раскладки.
+     */
+    void setupKeyBindings() {
+        keyBindings_.setAction("app.quit", [this] {
+            if (hasModalWindow()) return false;
+            exit();
+            return true;
+        });
+        keyBindings_.setAction("focus.next", [this] {
+            if (!focusedWindow_) return false;
+            focusedWindow_->focusNext();
+            return true;
+        });
+        keyBindings_.setAction("focus.prev", [this] {
+            if (!focusedWindow_) return false;
+            focusedWindow_->focusPrev();
+            return true;
+        });
+        keyBindings_.setAction("window.next", [this] {
+            if (windows_.empty()) return false;
+            focusNextWindow();
+            return true;
+        });
+
+        keyBindings_.bind("q", "app.quit");
+        keyBindings_.bind("Escape", "app.quit");
+        keyBindings_.bind("Tab", "focus.next");
+
+        keyBindings_.registerWidgetType<Button>("Button");
+        keyBindings_.registerWidgetType<Label>("Label");
+        keyBindings_.registerWidgetType<TextBox>("TextBox");
+        keyBindings_.registerWidgetType<CheckBox>("CheckBox");
+        keyBindings_.registerWidgetType<RadioButton>("RadioButton");
+        keyBindings_.registerWidgetType<ProgressBar>("ProgressBar");
+        keyBindings_.registerWidgetType<ListBox>("ListBox");
+        keyBindings_.registerWidgetType<Menu>("Menu");
+        keyBindings_.registerWidgetType<TabControl>("TabControl");
+        keyBindings_.registerWidgetType<DropDown>("DropDown");
+        keyBindings_.registerWidgetType<LogView>("LogView");
+        keyBindings_.registerWidgetType<DataGrid>("DataGrid");
+    }
+
     // Проверка наличия модальных окон
     bool hasModalWindow() const {
+        if (!modalStack_.empty()) return true;
         for (const auto& window : windows_) {
             if (window->visible() && window->isModal()) {
                 return true;
@@ -389,6 +1151,7 @@ public:
     // Удалить все окна
     void clearWindows() {
         windows_.clear();
+        hotkeyConflicts_.clear();
         focusedWindow_ = nullptr;
         statusBar_ = nullptr;
     }
@@ -0,0 +1,416 @@
+#ifndef TEXTUI_FRAMEENCODER_H
+#define TEXTUI_FRAMEENCODER_H
+
+#include "Sgr.h"
+#include "ThreadPool.h"
+#include "../graphics/Colors.h"
+#include <string>
+#include <vector>
+#include <thread>
+#include <cstdlib>
+
+namespace ui {
+
+/**
+ * @brief Ячейка экрана: символ и идентификатор стиля
+ *
+ * Роль темы разрешается в стиль через палитру Screen только при выводе.
+ */
+struct ScreenCell {
+    char ch = ' ';
+    StyleId style = makeStyleId(7, 0);  // Стиль или роль темы (roleStyleId)
+
+    bool operator==(const ScreenCell& other) const {
+        return ch == other.ch && style == other.style;
+    }
+    
+    bool operator!=(const ScreenCell& other) const {
+        return !(*this == other);
+    }
+    
+    // Создать из ColorAttr
+    static ScreenCell fromColorAttr(char c, const ColorAttr& attr) {
+        ScreenCell cell;
+        cell.ch = c;
+        cell.style = attr.styleId();
+        return cell;
+    }
+};
+
+/**
+ * @brief Необязательные возможности терминала
+ *
+ * Профиль определяет TerminalProbe (terminfo, переменные окружения,
+ * ответы терминала); FrameEncoder использует команды сжатия и
+ * синхронный вывод, остальное - для ввода и цвета.
+ */
+struct TerminalFeatures {
+    bool repeat = false;          // REP (CSI n b): повтор последнего символа
+    bool erase = false;           // ECH/EL (CSI n X, CSI K) стирают цветом фона (bce)
+    bool synchronized = false;    // синхронный вывод кадра (CSI ? 2026 h/l)
+    bool trueColor = false;       // 24-битный цвет (CSI 38;2;r;g;b m)
+    bool bracketedPaste = false;  // вставка в скобках (CSI ? 2004 h)
+    bool kittyKeyboard = false;   // протокол клавиатуры kitty (CSI > n u)
+    bool sgrMouse = false;        // мышь в формате SGR (CSI ? 1006 h)
+
+    // TERM=xterm* ставят и терминалы без REP
+    static bool repeatUnsupported() {
+        const char* program = std::getenv("TERM_PROGRAM");
+        const char* vte = std::getenv("VTE_VERSION");
+        bool appleTerminal = program && std::string(program) == "Apple_Terminal";
+        bool oldVte = vte && std::atoi(vte) < 6200;
+        return appleTerminal || oldVte;
+    }
+
+    /**
+     * @brief Возможности по TERM (и TERM_PROGRAM, VTE_VERSION, COLORTERM)
+     *
+     * Осторожная оценка без обращения к терминалу: неизвестный
+     * терминал получает только обычный вывод. Полное определение -
+     * TerminalProbe::detect.
+     */
+    static TerminalFeatures detect() {
+        TerminalFeatures features;
+#ifdef _WIN32
+        // Консоль с ENABLE_VIRTUAL_TERMINAL_PROCESSING
+        features.erase = true;
+#else
+        const char* termEnv = std::getenv("TERM");
+        std::string term = termEnv ? termEnv : "";
+        auto startsWith = [&term](const char* prefix) { return term.rfind(prefix, 0) == 0; };
+
+        bool xterm = startsWith("xterm");
+        bool modern = startsWith("tmux") || startsWith("foot") || startsWith("alacritty") ||
+                      startsWith("wezterm") || term == "xterm-kitty";
+        features.erase = xterm || modern || startsWith("linux") || startsWith("st-") ||
+                         startsWith("konsole") || startsWith("vte") || startsWith("gnome");
+        features.repeat = modern || (xterm && !repeatUnsupported());
+
+        const char* colorTerm = std::getenv("COLORTERM");
+        std::string colors = colorTerm ? colorTerm : "";
+        features.trueColor = colors == "truecolor" || colors == "24bit";
+#endif
+        return features;
+    }
+};
+
+/**
+ * @brief Сборка ANSI-вывода кадра
+ *
+ * Помнит позицию курсора и стиль на конце уже собранного вывода,
+ * чтобы не повторять перемещения и SGR-последовательности. Общий
+ * для синхронного вывода Screen и потока TerminalWriter.
+ *
+ * Большие кадры собираются полосами строк на пуле потоков (encodeRows):
+ * каждая полоса - в свой FrameEncoder, начиная с неизвестного
+ * состояния терминала; при склейке начало полосы (переход к первой
+ * ячейке и её стиль) собирается заново от конца предыдущей.
+ */
+class FrameEncoder {
+public:
+    static constexpr int kBandRows = 16;            // строк в полосе
+    static constexpr long kParallelCells = 8000;    // кадры меньше - в одном потоке
+
+private:
+    std::string out_;
+    int width_ = 80;
+    int gapLimit_ = 0;    // см. setGapLimit
+    TerminalFeatures features_;
+    bool parallel_ = std::thread::hardware_concurrency() > 1;
+    std::vector<FrameEncoder> bands_;
+
+    // Начало вывода: первая ячейка, её стиль и конец перехода к ней
+    // (перемещение и SGR) в out_
+    bool headSet_ = false;
+    int headX_ = 0;
+    int headY_ = 0;
+    StyleId headStyle_ = 0;
+    size_t headEnd_ = 0;
+
+    // Позиция курсора (-1 - неизвестна)
+    int cursorX_ = -1;
+    int cursorY_ = -1;
+
+    // Стиль, действующий в терминале на конце out_
+    StyleId outStyle_ = 0;
+    bool outStyleKnown_ = false;
+
+    void appendNumber(int value) {
+        char digits[12];
+        int n = 0;
+        do {
+            digits[n++] = static_cast<char>('0' + value % 10);
+            value /= 10;
+        } while (value > 0);
+        while (n > 0) out_.push_back(digits[--n]);
+    }
+
+    static int digitCount(int value) {
+        int n = 1;
+        while (value >= 10) {
+            value /= 10;
+            n++;
+        }
+        return n;
+    }
+
+    // CSI <value> <final>
+    void appendCsi(int value, char final) {
+        out_.append("\033[", 2);
+        appendNumber(value);
+        out_.push_back(final);
+    }
+
+public:
+    // Начать кадр экрана шириной width
+    void begin(int width) {
+        width_ = width;
+        out_.clear();
+        headSet_ = false;
+    }
+
+    // Начать полосу кадра frame: состояние терминала неизвестно
+    void beginBand(const FrameEncoder& frame) {
+        width_ = frame.width_;
+        gapLimit_ = frame.gapLimit_;
+        features_ = frame.features_;
+        out_.clear();
+        headSet_ = false;
+        invalidateCursor();
+        outStyleKnown_ = false;
+    }
+
+    /**
+     * @brief Дописать вывод полосы band
+     *
+     * Переход к первой ячейке полосы и её стиль собираются от текущего
+     * состояния (как при сборке подряд), остальное копируется;
+     * состояние на конце становится состоянием полосы.
+     */
+    void appendBand(const FrameEncoder& band) {
+        if (band.out_.empty()) return;
+        moveCursor(band.headX_, band.headY_);
+        applyStyle(band.headStyle_);
+        out_.append(band.out_, band.headEnd_, std::string::npos);
+        cursorX_ = band.cursorX_;
+        cursorY_ = band.cursorY_;
+        outStyle_ = band.outStyle_;
+        outStyleKnown_ = band.outStyleKnown_;
+    }
+
+    /**
+     * @brief Собрать строки [0, height) кадра
+     *
+     * encodeRows(encoder, fromY, toY) собирает строки в encoder и может
+     * менять только данные этих строк. Кадры от kParallelCells ячеек
+     * делятся на полосы по kBandRows строк для ThreadPool::shared();
+     * меньшие и при setParallel(false) собираются прямо здесь.
+     */
+    template <class EncodeRows>
+    void encodeRows(int height, EncodeRows encodeRows) {
+        if (!parallel_ || height <= kBandRows ||
+            static_cast<long>(width_) * height < kParallelCells) {
+            encodeRows(*this, 0, height);
+            return;
+        }
+        size_t count = static_cast<size_t>((height + kBandRows - 1) / kBandRows);
+        if (bands_.size() < count) bands_.resize(count);
+        ThreadPool::shared().parallelEach(count, [&](size_t b) {
+            FrameEncoder& band = bands_[b];
+            int fromY = static_cast<int>(b) * kBandRows;
+            band.beginBand(*this);
+            encodeRows(band, fromY, std::min(fromY + kBandRows, height));
+        });
+        for (size_t b = 0; b < count; b++) appendBand(bands_[b]);
+    }
+
+    // Собирать большие кадры на пуле (по умолчанию - если ядер больше одного)
+    void setParallel(bool enable) { parallel_ = enable; }
+    bool isParallel() const { return parallel_; }
+
+    // Завершить кадр: сброс стиля (и рамка синхронного вывода);
+    // после него стиль терминала неизвестен
+    const std::string& finish() {
+        if (!out_.empty()) {
+            out_.append("\033[0m", 4);
+            // Терминал покажет кадр целиком, без промежуточного состояния
+            if (features_.synchronized) {
+                out_.insert(0, "\033[?2026h", 8);
+                out_.append("\033[?2026l", 8);
+            }
+        }
+        outStyleKnown_ = false;
+        return out_;
+    }
+
+    /**
+     * @brief Гранулярность разницы
+     *
+     * Неизменённые ячейки между изменёнными в одной строке (не больше
+     * cells подряд, того же стиля) выводятся заново вместо перемещения
+     * курсора: на медленной линии несколько символов короче CSI H.
+     * 0 - только изменённые ячейки.
+     */
+    void setGapLimit(int cells) { gapLimit_ = cells > 0 ? cells : 0; }
+    int getGapLimit() const { return gapLimit_; }
+
+    // Команды сжатия, которые понимает терминал (см. emitRun)
+    void setFeatures(const TerminalFeatures& features) { features_ = features; }
+    const TerminalFeatures& getFeatures() const { return features_; }
+
+    // Терминал мог изменить позицию курсора без нас
+    void invalidateCursor() {
+        cursorX_ = -1;
+        cursorY_ = -1;
+    }
+
+    // Переместить курсор с оптимизацией
+    void moveCursor(int x, int y) {
+        if (x == cursorX_ && y == cursorY_) return;
+        // В той же строке короче относительный сдвиг (CUF/CUB)
+        if (y == cursorY_ && cursorX_ >= 0) {
+            appendCsi(x > cursorX_ ? x - cursorX_ : cursorX_ - x, x > cursorX_ ? 'C' : 'D');
+            cursorX_ = x;
+            return;
+        }
+        out_.append("\033[", 2);
+        appendNumber(y + 1);
+        out_.push_back(';');
+        appendNumber(x + 1);
+        out_.push_back('H');
+        cursorX_ = x;
+        cursorY_ = y;
+    }
+
+    // Переключить стиль: разностная или полная последовательность из таблицы
+    void applyStyle(StyleId style) {
+        if (outStyleKnown_ && style == outStyle_) return;
+        if (outStyleKnown_) {
+            char seq[kSgrMaxLength];
+            out_.append(seq, encodeStyleChange(seq, outStyle_, style));
+        } else {
+            const SgrCode& full = kSgrTable[style];
+            out_.append(full.text, full.length);
+        }
+        outStyle_ = style;
+        outStyleKnown_ = true;
+    }
+
+    /**
+     * @brief Перейти к ячейке (x, y) перед выводом изменённой ячейки
+     * @param row ячейки строки y в том виде, в каком они на экране
+     * @param resolve StyleId ячейки -> литеральный стиль
+     */
+    template <class Resolve>
+    void advanceTo(int x, int y, const ScreenCell* row, Resolve resolve) {
+        int gap = x - cursorX_;
+        if (gap > 0 && gap <= gapLimit_ && y == cursorY_ && cursorX_ >= 0 && outStyleKnown_) {
+            int from = cursorX_;
+            bool sameStyle = true;
+            for (int i = from; i < x; i++) {
+                if (resolve(row[i].style) != outStyle_) {
+                    sameStyle = false;
+                    break;
+                }
+            }
+            if (sameStyle) {
+                for (int i = from; i < x; i++) emitChar(i, row[i].ch);
+                return;
+            }
+        }
+        moveCursor(x, y);
+    }
+
+    // Вывести символ; после последней колонки позиция курсора неизвестна
+    void emitChar(int x, char ch) {
+        out_.push_back(ch);
+        cursorX_ = (x + 1 < width_) ? x + 1 : -1;
+    }
+
+    /**
+     * @brief Вывести ячейку x и совпадающие с ней следующие одной командой
+     *
+     * Вызывается после advanceTo и applyStyle. Ячейки строки row с тем
+     * же символом и стилем, что у row[x], выводятся через REP, а пробелы
+     * - через ECH или EL (до конца строки), если терминал их понимает
+     * (setFeatures) и это короче. Пробелы с подчёркиванием или инверсией
+     * не стираются: стирание красит только фон.
+     * @return число выведенных ячеек (не меньше 1)
+     */
+    template <class Resolve>
+    int emitRun(int x, int y, const ScreenCell* row, int width, Resolve resolve) {
+        if (!headSet_) {
+            headSet_ = true;
+            headX_ = x;
+            headY_ = y;
+            headStyle_ = outStyle_;
+            headEnd_ = out_.size();
+        }
+        char ch = row[x].ch;
+        bool blank = ch == ' ' && features_.erase &&
+                     !(styleFlags(outStyle_) & (StyleFlags::Underline | StyleFlags::Inverse));
+        if ((!features_.repeat && !blank) || !outStyleKnown_) {
+            emitChar(x, ch);
+            return 1;
+        }
+
+        int count = 1;
+        while (x + count < width && row[x + count].ch == ch && resolve(row[x + count].style) == outStyle_) {
+            count++;
+        }
+
+        if (blank && x + count == width && count > 3) {
+            out_.append("\033[K", 3);   // EL: курсор остаётся на месте
+            cursorX_ = x;
+            cursorY_ = y;
+            return count;
+        }
+        // После ECH курсор тоже на месте: учитываем сдвиг за серию
+        if (blank && 2 * (3 + digitCount(count)) < count) {
+            appendCsi(count, 'X');
+            cursorX_ = x;
+            cursorY_ = y;
+            return count;
+        }
+        if (features_.repeat && count > 1 && 4 + digitCount(count - 1) < count) {
+            emitChar(x, ch);
+            appendCsi(count - 1, 'b');
+            cursorX_ = (x + count < width) ? x + count : -1;
+            return count;
+        }
+        emitChar(x, ch);
+        return 1;
+    }
+
+    /**
+     * @brief Вывести ячейки, отличающиеся от sent (литеральные стили)
+     * sent обновляется до cells
+     */
+    void encodeDiff(const ScreenCell* cells, ScreenCell* sent, int width, int height) {
+        encodeRows(height, [cells, sent, width](FrameEncoder& encoder, int fromY, int toY) {
+            encoder.encodeDiffRows(cells, sent, width, fromY, toY);
+        });
+    }
+
+    void encodeDiffRows(const ScreenCell* cells, ScreenCell* sent, int width, int fromY, int toY) {
+        for (int y = fromY; y < toY; y++) {
+            size_t row = static_cast<size_t>(y) * width;
+            for (int x = 0; x < width; x++) {
+                const ScreenCell& cell = cells[row + x];
+                if (cell == sent[row + x]) continue;
+                auto literal = [](StyleId style) { return style; };
+                advanceTo(x, y, sent + row, literal);
+                applyStyle(cell.style);
+                int count = emitRun(x, y, cells + row, width, literal);
+                for (int k = 0; k < count; k++) sent[row + x + k] = cells[row + x + k];
+                x += count - 1;
+            }
+        }
+    }
+
+    const std::string& output() const { return out_; }
+};
+
+} // namespace ui
+
+#endif // TEXTUI_FRAMEENCODER_H
@@ -3,7 +3,13 @@
 
 #include <cstdint>
 #include <string>
+#include <vector>
 #include <chrono>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include "Wakeup.h"
 
 #ifdef _WIN32
 #include <windows.h>
@@ -113,9 +119,10 @@ struct InputEvent {
     Key key;
     char ch;           // ASCII символ (если есть)
     bool isRepeat;     // Повтор нажатия
+    bool isRelease;    // Отпускание (только протокол клавиатуры kitty)
     uint32_t timestamp; // Время нажатия
 
-    InputEvent() : key(Key::None), ch(0), isRepeat(false), timestamp(0) {}
+    InputEvent() : key(Key::None), ch(0), isRepeat(false), isRelease(false), timestamp(0) {}
 
     bool isPrintable() const {
         return ch >= 32 && ch < 127;
@@ -165,6 +172,18 @@ struct InputEvent {
     }
 };
 
+/**
+ * @brief Получатель сырых байтов ввода (запись трассы, отладка)
+ *
+ * Вызывается после каждого readKey с байтами, из которых
+ * собрана клавиша. Только POSIX: в Windows консоль отдаёт коды.
+ */
+class InputTap {
+public:
+    virtual ~InputTap() = default;
+    virtual void inputRead(const char* bytes, size_t count) = 0;
+};
+
 /**
  * @brief Ввод с клавиатуры с поддержкой модификаторов
  */
@@ -181,9 +200,27 @@ private:
 #else
     struct termios originalTermios;
     bool termiosSaved = false;
+    int fd_ = STDIN_FILENO;   // источник ввода
 #endif
     bool initialized = false;
     bool rawModeEnabled = false;
+    bool headless_ = false;
+
+    // Байты текущей клавиши для InputTap
+    InputTap* tap_ = nullptr;
+
+    // Пробуждение ожидания фоновыми потоками (см. setWakeup)
+    Wakeup* wakeup_ = nullptr;
+    std::string tapBytes_;
+
+    // Протокол клавиатуры kitty (см. setKittyKeyboard)
+    enum class KeyAction { Press, Repeat, Release };
+    KeyAction lastAction_ = KeyAction::Press;
+    bool kittyKeyboard_ = false;   // терминал его понимает
+    bool kittyActive_ = false;     // флаги отправлены терминалу
+
+    // Вывод служебных последовательностей (см. setControlOutput)
+    std::function<void(const char*)> controlOutput_;
     
     // Состояние модификаторов
     bool altPressed_ = false;
@@ -216,6 +253,23 @@ public:
         return true;
     }
 
+#ifndef _WIN32
+    /**
+     * @brief Ввод без терминала: клавиши читаются из fd
+     *
+     * Режимы терминала не трогаются (raw mode ничего не делает).
+     * Используется для воспроизведения записанного ввода
+     * (InputReplay); fd остаётся за вызывающим.
+     */
+    bool initHeadless(int fd) {
+        if (initialized) return false;
+        fd_ = fd;
+        headless_ = true;
+        initialized = true;
+        return true;
+    }
+#endif
+
     // Завершение
     void shutdown() {
         if (!initialized) return;
@@ -228,7 +282,9 @@ public:
         if (termiosSaved) {
             tcsetattr(STDIN_FILENO, TCSANOW, &originalTermios);
         }
+        fd_ = STDIN_FILENO;
 #endif
+        headless_ = false;
         initialized = false;
     }
 
@@ -246,6 +302,7 @@ public:
             raw.c_cc[VTIME] = 0;
             tcsetattr(STDIN_FILENO, TCSANOW, &raw);
         }
+        if (kittyKeyboard_) pushKittyFlags();
 #endif
         rawModeEnabled = true;
     }
@@ -257,6 +314,7 @@ public:
 #ifdef _WIN32
         SetConsoleMode(hIn, originalInMode | ENABLE_EXTENDED_FLAGS);
 #else
+        popKittyFlags();
         if (termiosSaved) {
             tcsetattr(STDIN_FILENO, TCSANOW, &originalTermios);
         }
@@ -264,8 +322,251 @@ public:
         rawModeEnabled = false;
     }
 
-    // Чтение клавиши (возвращает Key с модификаторами)
+    /**
+     * @brief Протокол клавиатуры kitty, если терминал его понимает
+     *
+     * В устаревшей кодировке одиночный ESC неотличим от начала
+     * последовательности, и readKey угадывает по тому, успело ли прийти
+     * продолжение. С протоколом (флаги 1 и 2: однозначные коды и типы
+     * событий) Escape приходит как CSI 27 u, сочетания с Alt и Ctrl - как
+     * CSI код;модификаторы u, отпускание - с типом события 3; ESC всегда
+     * начинает последовательность, и её продолжение читается без
+     * угадывания. Если терминал флаги всё же не принял (профиль ошибся),
+     * одиночный ESC распознаётся через kEscapeWaitMs, а не висит до
+     * следующей клавиши. Флаги отправляются на время raw mode и снимаются
+     * при выходе из него. Терминалы без протокола остаются на старом разборе.
+     * App::init включает его по профилю терминала (TerminalFeatures).
+     */
+    void setKittyKeyboard(bool enable) {
+        kittyKeyboard_ = enable;
+#ifndef _WIN32
+        if (!rawModeEnabled) return;
+        if (enable) {
+            pushKittyFlags();
+        } else {
+            popKittyFlags();
+        }
+#endif
+    }
+
+    bool isKittyKeyboard() const { return kittyActive_; }
+
+    /**
+     * @brief Куда писать служебные последовательности ввода (флаги kitty)
+     *
+     * С асинхронным выводом кадры пишет поток Screen, и прямая запись
+     * в stdout могла бы попасть в середину кадра; App направляет их в
+     * Screen::sendControl. nullptr - прямо в stdout.
+     */
+    void setControlOutput(std::function<void(const char*)> output) { controlOutput_ = std::move(output); }
+
+    // Чтение клавиши (возвращает Key с модификаторами); отпускание - Key::None
     Key readKey() {
+        Key key = readAnyKey();
+        return lastAction_ == KeyAction::Release ? Key::None : key;
+    }
+
+private:
+    Key readAnyKey() {
+        lastAction_ = KeyAction::Press;
+        Key key = decodeKey();
+        if (tap_ && !tapBytes_.empty()) {
+            tap_->inputRead(tapBytes_.data(), tapBytes_.size());
+            tapBytes_.clear();
+        }
+        return key;
+    }
+
+#ifndef _WIN32
+    static constexpr int kMaxCsiLength = 32;
+    static constexpr int kEscapeWaitMs = 50;   // продолжение ESC при протоколе kitty
+
+    bool waitInput(int timeoutMs) {
+        fd_set fds;
+        FD_ZERO(&fds);
+        FD_SET(fd_, &fds);
+        struct timeval tv;
+        tv.tv_sec = timeoutMs / 1000;
+        tv.tv_usec = (timeoutMs % 1000) * 1000;
+        return select(fd_ + 1, &fds, nullptr, nullptr, &tv) > 0;
+    }
+
+    ssize_t readByte(char* ch) {
+        ssize_t n = read(fd_, ch, 1);
+        if (n > 0 && tap_) tapBytes_.push_back(*ch);
+        return n;
+    }
+
+    // CSI > 3 u: однозначные коды и типы событий; CSI < u - вернуть прежние
+    void pushKittyFlags() {
+        if (kittyActive_ || headless_) return;
+        kittyActive_ = sendControl("\033[>3u");
+    }
+
+    void popKittyFlags() {
+        if (!kittyActive_) return;
+        kittyActive_ = !sendControl("\033[<u");
+    }
+
+    bool sendControl(const char* sequence) {
+        if (controlOutput_) {
+            controlOutput_(sequence);
+            return true;
+        }
+        fflush(stdout);
+        size_t length = strlen(sequence);
+        return write(STDOUT_FILENO, sequence, length) == static_cast<ssize_t>(length);
+    }
+
+    static Key withModifiers(Key key, int modifiers) {
+        // 1 + биты: Shift 1, Alt 2, Ctrl 4
+        int bits = modifiers > 0 ? modifiers - 1 : 0;
+        int value = static_cast<int>(key);
+        if (bits & 1) value |= static_cast<int>(Key::ShiftMask);
+        if (bits & 2) value |= static_cast<int>(Key::AltMask);
+        if (bits & 4) value |= static_cast<int>(Key::CtrlMask);
+        return static_cast<Key>(value);
+    }
+
+    // Код клавиши kitty (Unicode) в Key; буквы с Alt/Ctrl - как Alt()/Ctrl()
+    static Key kittyKey(int code, int modifiers) {
+        switch (code) {
+            case 27: return Key::Escape;
+            case 13: return Key::Enter;
+            case 57414: return Key::Enter;   // Enter цифрового блока
+            case 9: return Key::Tab;
+            case 8:
+            case 127: return Key::Backspace;
+            case 32: return Key::Space;
+        }
+        if (code > 32 && code < 127) {
+            bool chord = modifiers > 1 && ((modifiers - 1) & 6);
+            return static_cast<Key>(chord ? toupper(code) : code);
+        }
+        return Key::None;
+    }
+
+    // CSI <номер> ~
+    static Key tildeKey(int number) {
+        switch (number) {
+            case 1: case 7: return Key::Home;
+            case 2: return Key::Insert;
+            case 3: return Key::Delete;
+            case 4: case 8: return Key::End;
+            case 5: return Key::PageUp;
+            case 6: return Key::PageDown;
+            case 11: return Key::F1;
+            case 12: return Key::F2;
+            case 13: return Key::F3;
+            case 14: return Key::F4;
+            case 15: return Key::F5;
+            case 17: return Key::F6;
+            case 18: return Key::F7;
+            case 19: return Key::F8;
+            case 20: return Key::F9;
+            case 21: return Key::F10;
+            case 23: return Key::F11;
+            case 24: return Key::F12;
+        }
+        return Key::None;
+    }
+
+    /**
+     * @brief Разобрать CSI после "ESC ["
+     *
+     * Поля через ';', подполя через ':': "код[:...];модификаторы[:событие]".
+     * Понимает и устаревшие последовательности (CSI A, CSI 1;5 A, CSI 5 ~).
+     */
+    Key decodeCsi() {
+        std::string params;
+        char final = 0;
+        for (int i = 0; i < kMaxCsiLength; i++) {
+            char c = 0;
+            if (readByte(&c) <= 0) return Key::Escape;
+            if (c >= 0x40 && c <= 0x7E) {
+                final = c;
+                break;
+            }
+            params.push_back(c);
+        }
+        if (!final) return Key::None;
+
+        // field(i, sub): число или fallback, если поле пустое
+        auto field = [&params](int index, int sub, int fallback) {
+            size_t pos = 0;
+            for (int i = 0; i < index; i++) {
+                pos = params.find(';', pos);
+                if (pos == std::string::npos) return fallback;
+                pos++;
+            }
+            size_t end = params.find(';', pos);
+            if (end == std::string::npos) end = params.size();
+            for (int i = 0; i < sub; i++) {
+                pos = params.find(':', pos);
+                if (pos == std::string::npos || pos >= end) return fallback;
+                pos++;
+            }
+            int value = 0;
+            bool any = false;
+            while (pos < end && params[pos] >= '0' && params[pos] <= '9') {
+                value = value * 10 + (params[pos++] - '0');
+                any = true;
+            }
+            return any ? value : fallback;
+        };
+
+        int modifiers = field(1, 0, 1);
+        int event = field(1, 1, 1);
+        Key key = Key::None;
+        switch (final) {
+            case 'u': key = kittyKey(field(0, 0, 0), modifiers); break;
+            case '~': key = tildeKey(field(0, 0, 0)); break;
+            case 'A': key = Key::Up; break;
+            case 'B': key = Key::Down; break;
+            case 'C': key = Key::Right; break;
+            case 'D': key = Key::Left; break;
+            case 'H': key = Key::Home; break;
+            case 'F': key = Key::End; break;
+            case 'P': key = Key::F1; break;
+            case 'Q': key = Key::F2; break;
+            case 'R': key = Key::F3; break;
+            case 'S': key = Key::F4; break;
+        }
+        if (key == Key::None) return Key::None;
+        if (event == 2) lastAction_ = KeyAction::Repeat;
+        if (event == 3) lastAction_ = KeyAction::Release;
+        return withModifiers(key, modifiers);
+    }
+
+    // Продолжение после ESC
+    Key decodeEscape() {
+        char ch = 0;
+        if (readByte(&ch) <= 0) return Key::Escape;
+        if (ch == '[') return decodeCsi();
+        if (ch == 'O') {
+            // F1-F4 и стрелки в режиме приложения
+            if (readByte(&ch) <= 0) return Key::Escape;
+            switch (ch) {
+                case 'P': return Key::F1;
+                case 'Q': return Key::F2;
+                case 'R': return Key::F3;
+                case 'S': return Key::F4;
+                case 'A': return Key::Up;
+                case 'B': return Key::Down;
+                case 'C': return Key::Right;
+                case 'D': return Key::Left;
+                case 'H': return Key::Home;
+                case 'F': return Key::End;
+            }
+            return Key::None;
+        }
+        // ESC перед символом - Alt (meta посылает escape)
+        if (ch > 32 && ch < 127) return Alt(ch);
+        return Key::Escape;
+    }
+#endif
+
+    Key decodeKey() {
 #ifdef _WIN32
         if (!_kbhit()) return Key::None;
 
@@ -317,6 +618,10 @@ public:
         } else if (ch >= 32 && ch < 127) {
             // Обычный символ
             key = static_cast<Key>(ch);
+        } else if (ch >= 1 && ch <= 26) {
+            // Ctrl+буква приходит управляющим символом
+            key = Ctrl(static_cast<char>('a' + ch - 1));
+            ctrlPressed_ = false;
         }
 
         // Применяем модификаторы
@@ -333,66 +638,22 @@ public:
 
 #else
         char ch = 0;
-        ssize_t n = read(STDIN_FILENO, &ch, 1);
+        ssize_t n = readByte(&ch);
 
         if (n <= 0) return Key::None;
 
         // Escape последовательности
         if (ch == 27) {
-            char seq[4] = {0};
-            
-            // Пробуем прочитать продолжение
-            fcntl(STDIN_FILENO, F_SETFL, O_NONBLOCK);
-            n = read(STDIN_FILENO, &seq[0], 1);
-            
-            if (n <= 0) {
-                fcntl(STDIN_FILENO, F_SETFL, 0);
-                return Key::Escape;
-            }
-
-            if (seq[0] == '[') {
-                n = read(STDIN_FILENO, &seq[1], 1);
-                
-                if (n > 0 && seq[1] >= '0' && seq[1] <= '9') {
-                    // Расширенная последовательность (F5-F8)
-                    n = read(STDIN_FILENO, &seq[2], 1);
-                    if (seq[2] == '~') {
-                        int code = (seq[1] - '0') * 10 + (seq[2] - '0');
-                        switch (code) {
-                            case 15: return Key::F5;
-                            case 17: return Key::F6;
-                            case 18: return Key::F7;
-                            case 19: return Key::F8;
-                            case 20: return Key::F9;
-                            case 21: return Key::F10;
-                        }
-                    }
-                } else if (n > 0) {
-                    switch (seq[1]) {
-                        case 'A': return Key::Up;
-                        case 'B': return Key::Down;
-                        case 'C': return Key::Right;
-                        case 'D': return Key::Left;
-                        case 'H': return Key::Home;
-                        case 'F': return Key::End;
-                        case '3': return Key::Delete;
-                        case '5': return Key::PageUp;
-                        case '6': return Key::PageDown;
-                    }
-                }
-            } else if (seq[0] == 'O') {
-                // F1-F4
-                n = read(STDIN_FILENO, &seq[1], 1);
-                switch (seq[1]) {
-                    case 'P': return Key::F1;
-                    case 'Q': return Key::F2;
-                    case 'R': return Key::F3;
-                    case 'S': return Key::F4;
-                }
-            }
-
-            fcntl(STDIN_FILENO, F_SETFL, 0);
-            return Key::Escape;
+            // С протоколом kitty ESC начинает последовательность, и её байты
+            // приходят вместе с ним; ожидание ограничено на случай, если
+            // терминал протокол не включил. Иначе одиночный ESC - если
+            // продолжение не успело прийти
+            if (kittyActive_) waitInput(kEscapeWaitMs);
+            int flags = fcntl(fd_, F_GETFL);
+            fcntl(fd_, F_SETFL, flags | O_NONBLOCK);
+            Key key = decodeEscape();
+            fcntl(fd_, F_SETFL, flags);
+            return key;
         }
 
         // Обычные символы
@@ -405,20 +666,27 @@ public:
             return static_cast<Key>(ch);
         }
 
+        // Ctrl+буква (кроме занятых Tab, Enter и Backspace)
+        if (ch >= 1 && ch <= 26) {
+            return Ctrl(static_cast<char>('a' + ch - 1));
+        }
+
         return Key::None;
 #endif
     }
 
+public:
     // Чтение события ввода
     InputEvent readEvent() {
         InputEvent event;
-        event.key = readKey();
+        event.key = readAnyKey();
         
         if (event.key != Key::None) {
             event.ch = (static_cast<int>(event.key) < 128) 
                        ? static_cast<char>(static_cast<int>(event.key)) 
                        : 0;
-            event.isRepeat = false;
+            event.isRepeat = lastAction_ == KeyAction::Repeat;
+            event.isRelease = lastAction_ == KeyAction::Release;
             event.timestamp = 0;  // Можно добавить таймер
         }
         
@@ -432,17 +700,35 @@ public:
 #else
         fd_set fds;
         FD_ZERO(&fds);
-        FD_SET(STDIN_FILENO, &fds);
+        FD_SET(fd_, &fds);
         
         struct timeval tv;
         tv.tv_sec = 0;
         tv.tv_usec = 0;
         
-        return select(STDIN_FILENO + 1, &fds, nullptr, nullptr, &tv) > 0;
+        return select(fd_ + 1, &fds, nullptr, nullptr, &tv) > 0;
 #endif
     }
 
-    // Ожидание ввода с таймаутом
+    /**
+     * @brief Забрать все уже пришедшие клавиши, не ожидая новых
+     * @param maxKeys предел чтений за вызов: поток ввода не должен
+     *        задерживать кадр бесконечно
+     * @return число добавленных в out клавиш
+     */
+    size_t drainKeys(std::vector<Key>& out, size_t maxKeys) {
+        size_t added = 0;
+        for (size_t i = 0; i < maxKeys && hasInput(); i++) {
+            Key key = readKey();
+            if (key != Key::None) {
+                out.push_back(key);
+                added++;
+            }
+        }
+        return added;
+    }
+
+    // Ожидание ввода с таймаутом; Key::None - таймаут или пробуждение (setWakeup)
     Key waitKey(int timeout_ms) {
 #ifdef _WIN32
         auto start = std::chrono::steady_clock::now();
@@ -451,6 +737,7 @@ public:
             if (_kbhit()) {
                 return readKey();
             }
+            if (wakeup_ && wakeup_->isSignaled()) return Key::None;
 #ifdef _WIN32
             Sleep(10);
 #else
@@ -461,21 +748,42 @@ public:
 #else
         fd_set fds;
         FD_ZERO(&fds);
-        FD_SET(STDIN_FILENO, &fds);
+        FD_SET(fd_, &fds);
+        int maxFd = fd_;
+        int wakeFd = wakeup_ ? wakeup_->fd() : -1;
+        if (wakeFd >= 0) {
+            FD_SET(wakeFd, &fds);
+            if (wakeFd > maxFd) maxFd = wakeFd;
+        }
         
         struct timeval tv;
         tv.tv_sec = timeout_ms / 1000;
         tv.tv_usec = (timeout_ms % 1000) * 1000;
         
-        if (select(STDIN_FILENO + 1, &fds, nullptr, nullptr, &tv) > 0) {
+        if (select(maxFd + 1, &fds, nullptr, nullptr, &tv) > 0 && FD_ISSET(fd_, &fds)) {
             return readKey();
         }
         return Key::None;
 #endif
     }
 
+    /**
+     * @brief Будить waitKey сигналом из фоновых потоков (nullptr - снять)
+     * Сигнал не забирается: это делает владелец цикла (Wakeup::consume).
+     */
+    void setWakeup(Wakeup* wakeup) { wakeup_ = wakeup; }
+
+    // Получатель сырых байтов (nullptr - снять)
+    void setTap(InputTap* tap) {
+        tap_ = tap;
+        tapBytes_.clear();
+    }
+
+    InputTap* getTap() const { return tap_; }
+
     bool isInitialized() const { return initialized; }
     bool isRawModeEnabled() const { return rawModeEnabled; }
+    bool isHeadless() const { return headless_; }
 };
 
 } // namespace ui
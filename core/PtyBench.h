@@ -0,0 +1,384 @@
+#ifndef TEXTUI_PTYBENCH_H
+#define TEXTUI_PTYBENCH_H
+
+#include "InputReplay.h"
+#include <string>
+#include <vector>
+#include <functional>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cerrno>
+
+#ifndef _WIN32
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <termios.h>
+#include <sys/ioctl.h>
+#include <sys/wait.h>
+#endif
+
+namespace ui {
+
+#ifndef _WIN32
+
+// Сценарий замера: интерфейс и нажимаемые клавиши
+struct PtyScenario {
+    std::string name;
+    std::function<void(App&)> build;   // интерфейс внутри программы
+    std::vector<std::string> keys;     // байты клавиш по одной на замер
+};
+
+struct PtyReport {
+    struct Interaction {
+        uint64_t firstByteUs = 0;   // от записи клавиши до первого байта ответа
+        uint64_t lastByteUs = 0;    // до последнего байта перед тишиной
+        uint64_t bytes = 0;         // байт вывода
+        bool responded = false;     // вывод был до таймаута
+    };
+
+    std::string name;
+    std::vector<Interaction> interactions;
+    uint64_t bytes = 0;
+    uint64_t silent = 0;            // клавиши без вывода
+
+    // p-й процентиль задержки до последнего байта (только с ответом), мкс
+    double percentileUs(double p) const { return percentile(p, false); }
+    double firstBytePercentileUs(double p) const { return percentile(p, true); }
+
+    double bytesPerInteraction() const {
+        return interactions.empty() ? 0 : static_cast<double>(bytes) / interactions.size();
+    }
+
+private:
+    double percentile(double p, bool first) const {
+        std::vector<uint64_t> values;
+        for (const Interaction& interaction : interactions) {
+            if (!interaction.responded) continue;
+            values.push_back(first ? interaction.firstByteUs : interaction.lastByteUs);
+        }
+        return percentileOf(std::move(values), p);
+    }
+};
+
+/**
+ * @brief Замер задержки "клавиша - вывод" через псевдотерминал
+ *
+ * Программа запускается на подчинённой стороне pty, как в настоящем
+ * терминале. Байты клавиши пишутся в ведущую сторону, время
+ * отмечается по первому и последнему байту ответа: вывод считается
+ * законченным, когда терминал молчит quietMs. Так учитывается всё,
+ * что видит пользователь: разбор escape-последовательностей, ожидание
+ * в главном цикле, сборка и запись кадра.
+ *
+ *     ui::PtyBench bench;
+ *     ui::PtyScenario scenario = ui::PtyBench::listScrollScenario(200);
+ *     ui::PtyReport report = bench.run(scenario);
+ *     printf("%s p50 %.0f us\n", report.name.c_str(), report.percentileUs(50));
+ */
+class PtyBench {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr int kQuietMs = 50;        // тишина - кадр закончен
+    static constexpr int kTimeoutMs = 1000;    // ответа нет
+    static constexpr int kStartupMs = 3000;    // первый кадр программы
+    static constexpr int kStartupQuietMs = 300;  // App::run сбрасывает ввод после паузы 100 мс
+
+private:
+    int master_ = -1;
+    pid_t child_ = -1;
+    int quietMs_ = kQuietMs;
+    int timeoutMs_ = kTimeoutMs;
+    char buffer_[4096];
+
+    // Открыть pty и запустить дочерний процесс; в нём выполняется exec
+    bool spawn(int width, int height, const std::function<void()>& exec) {
+        stop();
+        int master = posix_openpt(O_RDWR | O_NOCTTY);
+        if (master < 0) return false;
+        if (grantpt(master) != 0 || unlockpt(master) != 0) {
+            ::close(master);
+            return false;
+        }
+        const char* slaveName = ptsname(master);
+        if (!slaveName) {
+            ::close(master);
+            return false;
+        }
+        std::string slavePath = slaveName;
+
+        struct winsize size = {};
+        size.ws_col = static_cast<unsigned short>(width);
+        size.ws_row = static_cast<unsigned short>(height);
+
+        pid_t pid = fork();
+        if (pid < 0) {
+            ::close(master);
+            return false;
+        }
+        if (pid == 0) {
+            // Подчинённая сторона становится управляющим терминалом
+            ::close(master);
+            setsid();
+            int slave = ::open(slavePath.c_str(), O_RDWR);
+            if (slave < 0) _exit(127);
+            ioctl(slave, TIOCSCTTY, 0);
+            ioctl(slave, TIOCSWINSZ, &size);
+            dup2(slave, STDIN_FILENO);
+            dup2(slave, STDOUT_FILENO);
+            dup2(slave, STDERR_FILENO);
+            if (slave > STDERR_FILENO) ::close(slave);
+            exec();
+            _exit(127);
+        }
+
+        master_ = master;
+        child_ = pid;
+        return true;
+    }
+
+    // Прочитать, что есть, ждать не дольше timeoutMs; -1 - программа закрыла pty
+    ssize_t readSome(int timeoutMs) {
+        struct pollfd pfd;
+        pfd.fd = master_;
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+        int ready = ::poll(&pfd, 1, timeoutMs);
+        if (ready < 0 && errno == EINTR) return 0;
+        if (ready <= 0) return 0;
+        ssize_t n = ::read(master_, buffer_, sizeof(buffer_));
+        if (n < 0 && (errno == EAGAIN || errno == EINTR)) return 0;
+        return n > 0 ? n : -1;
+    }
+
+    static uint64_t microsSince(Clock::time_point from, Clock::time_point to) {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(to - from).count());
+    }
+
+public:
+    PtyBench() = default;
+    ~PtyBench() { stop(); }
+
+    PtyBench(const PtyBench&) = delete;
+    PtyBench& operator=(const PtyBench&) = delete;
+
+    // Тишина, после которой вывод на клавишу считается законченным
+    void setQuietMs(int ms) { quietMs_ = ms > 0 ? ms : 1; }
+    void setTimeoutMs(int ms) { timeoutMs_ = ms > 0 ? ms : 1; }
+
+    // Запустить программу argv[0] (ищется в PATH)
+    bool launch(const std::vector<std::string>& argv, int width = 80, int height = 25) {
+        if (argv.empty()) return false;
+        return spawn(width, height, [&argv]() {
+            std::vector<char*> args;
+            for (const std::string& arg : argv) args.push_back(const_cast<char*>(arg.c_str()));
+            args.push_back(nullptr);
+            setenv("TERM", "xterm-256color", 1);
+            setenv("TEXTUI_TERMINAL_PROBE", "0", 1);  // профиль только по TERM, без кэша
+            execvp(args[0], args.data());
+        });
+    }
+
+    /**
+     * @brief Запустить main в дочернем процессе (код возврата - статус выхода)
+     *
+     * Дочерний процесс получается fork() без exec, а в нём остаётся
+     * только вызывающий поток. Вызывать до того, как в процессе
+     * запущен хоть один поток TextUI (ThreadPool::shared(), асинхронный
+     * вывод, ThemeWatcher, фильтрация и индексация в фоне): иначе
+     * ребёнок унаследует пул без рабочих и мьютексы, захваченные
+     * мёртвыми потоками, и повиснет. Программу, где потоки уже
+     * есть, запускают через launch(argv) - отдельным процессом.
+     */
+    bool launch(const std::function<int()>& main, int width = 80, int height = 25) {
+        return spawn(width, height, [&main]() {
+            setenv("TERM", "xterm-256color", 1);
+            setenv("TEXTUI_TERMINAL_PROBE", "0", 1);  // профиль только по TERM, без кэша
+            int status = main();
+            fflush(stdout);
+            _exit(status);
+        });
+    }
+
+    bool isRunning() const { return child_ > 0; }
+
+    /**
+     * @brief Дождаться, пока программа замолчит (первый кадр)
+     * @param quietMs сколько длится тишина
+     * @return байт вывода за ожидание
+     */
+    uint64_t waitQuiet(int quietMs = kStartupQuietMs, int limitMs = kStartupMs) {
+        uint64_t total = 0;
+        Clock::time_point start = Clock::now();
+        Clock::time_point lastOutput = start;
+        bool any = false;
+        for (;;) {
+            Clock::time_point now = Clock::now();
+            int elapsed = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(now - start).count());
+            if (elapsed >= limitMs) break;
+            int quiet = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(now - lastOutput).count());
+            if (any && quiet >= quietMs) break;
+            ssize_t n = readSome(any ? quietMs - quiet : limitMs - elapsed);
+            if (n < 0) break;
+            if (n > 0) {
+                total += static_cast<uint64_t>(n);
+                lastOutput = Clock::now();
+                any = true;
+            }
+        }
+        return total;
+    }
+
+    // Нажать клавишу (байты как от терминала) и замерить ответ
+    PtyReport::Interaction press(const std::string& bytes) {
+        PtyReport::Interaction result;
+        if (master_ < 0) return result;
+
+        Clock::time_point sent = Clock::now();
+        size_t done = 0;
+        while (done < bytes.size()) {
+            ssize_t n = ::write(master_, bytes.data() + done, bytes.size() - done);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) return result;
+            done += static_cast<size_t>(n);
+        }
+
+        Clock::time_point lastOutput = sent;
+        for (;;) {
+            Clock::time_point now = Clock::now();
+            int wait;
+            if (result.responded) {
+                int quiet = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(now - lastOutput).count());
+                if (quiet >= quietMs_) break;
+                wait = quietMs_ - quiet;
+            } else {
+                int elapsed = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(now - sent).count());
+                if (elapsed >= timeoutMs_) break;
+                wait = timeoutMs_ - elapsed;
+            }
+            ssize_t n = readSome(wait);
+            if (n < 0) break;
+            if (n == 0) continue;
+            lastOutput = Clock::now();
+            if (!result.responded) {
+                result.firstByteUs = microsSince(sent, lastOutput);
+                result.responded = true;
+            }
+            result.lastByteUs = microsSince(sent, lastOutput);
+            result.bytes += static_cast<uint64_t>(n);
+        }
+        return result;
+    }
+
+    // Нажать клавиши по очереди (каждую - после ответа на прошлую)
+    PtyReport measure(const std::string& name, const std::vector<std::string>& keys) {
+        PtyReport report;
+        report.name = name;
+        report.interactions.reserve(keys.size());
+        for (const std::string& key : keys) {
+            PtyReport::Interaction interaction = press(key);
+            report.bytes += interaction.bytes;
+            if (!interaction.responded) report.silent++;
+            report.interactions.push_back(interaction);
+        }
+        return report;
+    }
+
+    /**
+     * @brief Прогнать сценарий в новой программе
+     *
+     * Дочерний процесс строит интерфейс сценария и крутит App::run;
+     * после замеров он завершается. Запускается через launch(main),
+     * поэтому те же условия: до первого потока TextUI в процессе.
+     */
+    PtyReport run(const PtyScenario& scenario, int width = 80, int height = 25) {
+        PtyReport report;
+        report.name = scenario.name;
+        std::function<void(App&)> build = scenario.build;
+        bool started = launch([build]() {
+            App app;
+            if (!app.init()) return 1;
+            if (build) build(app);
+            app.run();
+            return 0;
+        }, width, height);
+        if (!started) return report;
+        waitQuiet();
+        report = measure(scenario.name, scenario.keys);
+        stop();
+        return report;
+    }
+
+    // Завершить программу и закрыть pty; код выхода (-1 - не запущена)
+    int stop() {
+        int status = -1;
+        if (child_ > 0) {
+            kill(child_, SIGTERM);
+            int raw = 0;
+            if (waitpid(child_, &raw, 0) == child_ && WIFEXITED(raw)) status = WEXITSTATUS(raw);
+            child_ = -1;
+        }
+        if (master_ >= 0) {
+            ::close(master_);
+            master_ = -1;
+        }
+        return status;
+    }
+
+    // Стандартные сценарии
+
+    // Набор в TextBox: count клавиш, строки по kTypingRun символов стираются Backspace
+    static constexpr int kTypingRun = 40;
+
+    static PtyScenario typingScenario(int count) {
+        PtyScenario scenario;
+        scenario.name = "textbox-typing";
+        scenario.build = [](App& app) {
+            Window* window = app.createWindow(2, 2, 60, 8, "Typing");
+            app.addTextBox(window, 2, 2, kTypingRun + 10);
+            window->focusNext();
+        };
+        for (int i = 0; i < count; i++) {
+            bool erase = (i / kTypingRun) % 2 == 1;
+            scenario.keys.push_back(erase ? std::string("\b") : std::string(1, static_cast<char>('a' + i % 26)));
+        }
+        return scenario;
+    }
+
+    // Прокрутка ListBox на count строк вниз
+    static PtyScenario listScrollScenario(int count) {
+        PtyScenario scenario;
+        scenario.name = "listbox-scroll";
+        scenario.build = [count](App& app) {
+            Window* window = app.createWindow(2, 2, 60, 20, "Scrolling");
+            ListBox* list = app.addListBox(window, 2, 2, 50, 16);
+            for (int i = 0; i <= count; i++) list->addItem("Item " + std::to_string(i));
+            window->focusNext();
+        };
+        scenario.keys.assign(static_cast<size_t>(count), "\033[B");
+        return scenario;
+    }
+
+    // Раскрыть и закрыть DropDown count раз
+    static PtyScenario dropDownScenario(int count) {
+        PtyScenario scenario;
+        scenario.name = "dropdown-open";
+        scenario.build = [](App& app) {
+            Window* window = app.createWindow(2, 2, 60, 20, "DropDown");
+            DropDown* dropDown = app.addDropDown(window, 2, 2, 30);
+            for (int i = 0; i < 50; i++) dropDown->addItem("Option " + std::to_string(i));
+            window->focusNext();
+        };
+        scenario.keys.assign(static_cast<size_t>(count) * 2, "\r");
+        return scenario;
+    }
+};
+
+#endif // _WIN32
+
+} // namespace ui
+
+#endif // TEXTUI_PTYBENCH_H
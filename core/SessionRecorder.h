@@ -0,0 +1,268 @@
+#ifndef TEXTUI_SESSIONRECORDER_H
+#define TEXTUI_SESSIONRECORDER_H
+
+#include "Screen.h"
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+
+namespace ui {
+
+/**
+ * @brief Формат записи сессии
+ *
+ * Заголовок: "TUIREC1\n", время начала (мкс Unix, varint).
+ * Далее записи, каждая начинается байтом-тегом:
+ *
+ *     'S' ширина высота           - новый размер, экран пуст (пробелы,
+ *                                   стиль ScreenCell по умолчанию)
+ *     'F' dt число_серий серии... - кадр; dt - мкс от прошлого кадра
+ *
+ * Серия - подряд идущие (по строкам) изменённые ячейки одного стиля:
+ * пропуск от конца прошлой серии, длина, стиль, затем символы.
+ * Все числа - varint (7 бит на байт, младшие вперёд).
+ */
+class SessionFormat {
+public:
+    static constexpr const char* kMagic = "TUIREC1\n";
+    static constexpr size_t kMagicLength = 8;
+    static constexpr char kSizeTag = 'S';
+    static constexpr char kFrameTag = 'F';
+
+    static void putVarint(std::string& out, uint64_t value) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<char>(value));
+    }
+
+    // false - конец данных или испорченное число
+    static bool getVarint(FILE* in, uint64_t& value) {
+        value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            int byte = fgetc(in);
+            if (byte == EOF) return false;
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) return true;
+        }
+        return false;
+    }
+};
+
+/**
+ * @brief Запись того, что видел оператор
+ *
+ * Подключается к Screen как FrameObserver. Поток интерфейса только
+ * копирует кадр в свободный буфер из пула kMaxQueuedFrames; разницу
+ * с прошлым записанным кадром, кодирование и запись в файл делает
+ * фоновый поток. Если пул исчерпан, новый кадр занимает место последнего
+ * ещё не записанного: пропускается промежуточный кадр, а не самый свежий,
+ * и разница считается с последним записанным, поэтому итоговое состояние
+ * экрана в записи верно.
+ */
+class SessionRecorder : public FrameObserver {
+public:
+    static constexpr size_t kMaxQueuedFrames = 8;
+
+    struct Stats {
+        uint64_t frames = 0;         // записано кадров
+        uint64_t dropped = 0;        // пропущено (пул занят)
+        uint64_t bytes = 0;          // размер файла
+        double captureSeconds = 0;   // время в потоке интерфейса
+    };
+
+private:
+    struct Frame {
+        std::vector<ScreenCell> cells;
+        int width = 0;
+        int height = 0;
+        std::chrono::steady_clock::time_point time;
+    };
+
+    FILE* file_ = nullptr;
+    std::thread thread_;
+    std::mutex mutex_;
+    std::condition_variable ready_;
+    bool stop_ = true;
+    std::deque<Frame> queue_;        // ждут записи
+    std::vector<Frame> free_;        // буферы для повторного использования
+    size_t allocated_ = 0;
+
+    // Только фоновый поток
+    std::vector<ScreenCell> last_;
+    int lastWidth_ = 0;
+    int lastHeight_ = 0;
+    std::chrono::steady_clock::time_point lastTime_;
+    std::string out_;
+
+    std::atomic<uint64_t> frames_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> bytes_{0};
+    std::atomic<uint64_t> captureNanos_{0};
+
+    void encode(const Frame& frame) {
+        out_.clear();
+        if (frame.width != lastWidth_ || frame.height != lastHeight_) {
+            out_.push_back(SessionFormat::kSizeTag);
+            SessionFormat::putVarint(out_, static_cast<uint64_t>(frame.width));
+            SessionFormat::putVarint(out_, static_cast<uint64_t>(frame.height));
+            last_.assign(frame.cells.size(), ScreenCell{});
+            lastWidth_ = frame.width;
+            lastHeight_ = frame.height;
+        }
+
+        out_.push_back(SessionFormat::kFrameTag);
+        SessionFormat::putVarint(out_, static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(frame.time - lastTime_).count()));
+        lastTime_ = frame.time;
+
+        // Число серий заранее неизвестно: серии собираются отдельно
+        size_t countAt = out_.size();
+        std::string runs;
+        uint64_t count = 0;
+        size_t end = 0;   // конец прошлой серии
+        size_t size = frame.cells.size();
+        size_t i = 0;
+        while (i < size) {
+            if (frame.cells[i] == last_[i]) {
+                i++;
+                continue;
+            }
+            StyleId style = frame.cells[i].style;
+            size_t start = i;
+            while (i < size && frame.cells[i] != last_[i] && frame.cells[i].style == style) {
+                last_[i] = frame.cells[i];
+                i++;
+            }
+            SessionFormat::putVarint(runs, start - end);
+            SessionFormat::putVarint(runs, i - start);
+            SessionFormat::putVarint(runs, style);
+            for (size_t k = start; k < i; k++) runs.push_back(frame.cells[k].ch);
+            end = i;
+            count++;
+        }
+        std::string header;
+        SessionFormat::putVarint(header, count);
+        out_.insert(countAt, header);
+        out_.append(runs);
+    }
+
+    void writeLoop() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (;;) {
+            ready_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+            if (queue_.empty()) break;   // stop_
+            Frame frame = std::move(queue_.front());
+            queue_.pop_front();
+            lock.unlock();
+
+            encode(frame);
+            fwrite(out_.data(), 1, out_.size(), file_);
+            bytes_ += out_.size();
+            frames_++;
+
+            lock.lock();
+            free_.push_back(std::move(frame));
+        }
+        fflush(file_);
+    }
+
+public:
+    SessionRecorder() = default;
+    ~SessionRecorder() { stop(); }
+
+    SessionRecorder(const SessionRecorder&) = delete;
+    SessionRecorder& operator=(const SessionRecorder&) = delete;
+
+    bool start(const std::string& path) {
+        stop();
+        file_ = fopen(path.c_str(), "wb");
+        if (!file_) return false;
+
+        std::string header(SessionFormat::kMagic, SessionFormat::kMagicLength);
+        SessionFormat::putVarint(header, static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count()));
+        fwrite(header.data(), 1, header.size(), file_);
+        bytes_ = header.size();
+
+        last_.clear();
+        lastWidth_ = lastHeight_ = 0;
+        lastTime_ = std::chrono::steady_clock::now();
+        frames_ = dropped_ = captureNanos_ = 0;
+        stop_ = false;
+        thread_ = std::thread(&SessionRecorder::writeLoop, this);
+        return true;
+    }
+
+    // Дописать очередь и закрыть файл
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        ready_.notify_one();
+        if (thread_.joinable()) thread_.join();
+        if (file_) {
+            fclose(file_);
+            file_ = nullptr;
+        }
+    }
+
+    bool isRecording() const { return file_ != nullptr; }
+
+    void frameFlushed(const std::vector<ScreenCell>& cells, int width, int height) override {
+        auto started = std::chrono::steady_clock::now();
+        Frame frame;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (stop_) return;
+            if (!free_.empty()) {
+                frame = std::move(free_.back());
+                free_.pop_back();
+            } else if (allocated_ < kMaxQueuedFrames) {
+                allocated_++;
+            } else if (!queue_.empty()) {
+                // Заменить самый новый из ожидающих
+                frame = std::move(queue_.back());
+                queue_.pop_back();
+                dropped_++;
+            } else {
+                dropped_++;
+                return;
+            }
+        }
+        frame.cells.assign(cells.begin(), cells.end());
+        frame.width = width;
+        frame.height = height;
+        frame.time = started;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            queue_.push_back(std::move(frame));
+        }
+        ready_.notify_one();
+        captureNanos_ += static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - started).count());
+    }
+
+    Stats getStats() const {
+        Stats stats;
+        stats.frames = frames_;
+        stats.dropped = dropped_;
+        stats.bytes = bytes_;
+        stats.captureSeconds = static_cast<double>(captureNanos_) * 1e-9;
+        return stats;
+    }
+};
+
+} // namespace ui
+
+#endif // TEXTUI_SESSIONRECORDER_H
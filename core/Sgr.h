@@ -0,0 +1,130 @@
+#ifndef TEXTUI_SGR_H
+#define TEXTUI_SGR_H
+
+#include "../graphics/Colors.h"
+#include <array>
+#include <cstring>
+#include <cstddef>
+
+namespace ui {
+
+/**
+ * @brief Готовая escape-последовательность SGR
+ */
+struct SgrCode {
+    char text[24] = {};
+    uint8_t length = 0;
+
+    constexpr void append(const char* s) {
+        while (*s) text[length++] = *s++;
+    }
+};
+
+namespace detail {
+
+    // ANSI коды цветов в порядке BIOS (0-15 / 0-7)
+    constexpr const char* kSgrFg[16] = {"30", "34", "32", "36", "31", "35", "33", "37",
+                                        "90", "94", "92", "96", "91", "95", "93", "97"};
+    constexpr const char* kSgrBg[8] = {"40", "44", "42", "46", "41", "45", "43", "47"};
+
+    // Параметры атрибутов: bold, underline, inverse, blink
+    constexpr StyleId kSgrFlagBits[4] = {StyleFlags::Bold, StyleFlags::Underline,
+                                         StyleFlags::Inverse, StyleFlags::Blink};
+    constexpr const char* kSgrFlagCodes[4] = {"1", "4", "7", "5"};
+
+    // Фрагмент ";<код>" для сборки разностной последовательности
+    constexpr SgrCode makeParam(const char* code) {
+        SgrCode p;
+        p.append(";");
+        p.append(code);
+        return p;
+    }
+
+    // Полная последовательность: сброс + атрибуты + цвета
+    constexpr SgrCode makeFullSgr(StyleId id) {
+        SgrCode s;
+        s.append("\033[0");
+        for (int i = 0; i < 4; i++) {
+            if (id & kSgrFlagBits[i]) {
+                s.append(";");
+                s.append(kSgrFlagCodes[i]);
+            }
+        }
+        s.append(";");
+        s.append(kSgrFg[styleFg(id)]);
+        s.append(";");
+        s.append(kSgrBg[styleBg(id)]);
+        s.append("m");
+        return s;
+    }
+
+    constexpr std::array<SgrCode, kStyleCount> makeSgrTable() {
+        std::array<SgrCode, kStyleCount> table{};
+        for (StyleId id = 0; id < kStyleCount; id++) {
+            table[id] = makeFullSgr(id);
+        }
+        return table;
+    }
+
+    template<size_t N>
+    constexpr std::array<SgrCode, N> makeParamTable(const char* const (&codes)[N]) {
+        std::array<SgrCode, N> table{};
+        for (size_t i = 0; i < N; i++) {
+            table[i] = makeParam(codes[i]);
+        }
+        return table;
+    }
+
+} // namespace detail
+
+/**
+ * @brief Таблицы SGR, построенные при компиляции
+ *
+ * kSgrTable[id] - полная последовательность стиля, фрагменты
+ * параметров используются для разностных переходов.
+ */
+inline constexpr std::array<SgrCode, kStyleCount> kSgrTable = detail::makeSgrTable();
+inline constexpr std::array<SgrCode, 16> kSgrFgParams = detail::makeParamTable(detail::kSgrFg);
+inline constexpr std::array<SgrCode, 8> kSgrBgParams = detail::makeParamTable(detail::kSgrBg);
+inline constexpr std::array<SgrCode, 4> kSgrFlagParams = detail::makeParamTable(detail::kSgrFlagCodes);
+
+// Максимальная длина последовательности перехода
+constexpr size_t kSgrMaxLength = sizeof(SgrCode::text);
+
+/**
+ * @brief Последовательность перехода между стилями
+ *
+ * Если атрибуты только добавляются, выводятся лишь изменившиеся
+ * параметры ("\033[1;94m"), иначе - полная последовательность
+ * со сбросом. out должен вмещать kSgrMaxLength байт.
+ * @return длина записанной последовательности (0 - стиль не изменился)
+ */
+inline size_t encodeStyleChange(char* out, StyleId from, StyleId to) {
+    if (from == to) return 0;
+
+    const SgrCode& full = kSgrTable[to];
+    if (styleFlags(from) & ~styleFlags(to)) {
+        std::memcpy(out, full.text, full.length);
+        return full.length;
+    }
+
+    size_t n = 0;
+    out[n++] = '\033';
+    auto put = [&](const SgrCode& p) {
+        std::memcpy(out + n, p.text, p.length);
+        n += p.length;
+    };
+    StyleId added = styleFlags(to) & ~styleFlags(from);
+    for (int i = 0; i < 4; i++) {
+        if (added & detail::kSgrFlagBits[i]) put(kSgrFlagParams[i]);
+    }
+    if (styleFg(from) != styleFg(to)) put(kSgrFgParams[styleFg(to)]);
+    if (styleBg(from) != styleBg(to)) put(kSgrBgParams[styleBg(to)]);
+    out[1] = '[';  // первый ';' становится '['
+    out[n++] = 'm';
+    return n;
+}
+
+} // namespace ui
+
+#endif // TEXTUI_SGR_H
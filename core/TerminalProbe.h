@@ -0,0 +1,533 @@
+#ifndef TEXTUI_TERMINALPROBE_H
+#define TEXTUI_TERMINALPROBE_H
+
+#include "FrameEncoder.h"
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+#include <chrono>
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#ifndef _WIN32
+#include <unistd.h>
+#include <termios.h>
+#include <sys/select.h>
+#endif
+
+namespace ui {
+
+/**
+ * @brief Определение возможностей терминала с кэшем профиля на диске
+ *
+ * Первый запуск в терминале данного типа собирает профиль:
+ * 1. оценка по TERM, TERM_PROGRAM, COLORTERM (TerminalFeatures::detect);
+ * 2. terminfo: bce, rep, расширенные Tc/RGB, Sync, BE, XM;
+ * 3. запросы терминалу с коротким ожиданием: режимы DECRQM 2026, 2004,
+ *    1006, флаги клавиатуры kitty (CSI ? u), XTVERSION, DA2 и DA1.
+ *    DA1 понимают все терминалы, поэтому его ответ завершает ожидание
+ *    раньше таймаута.
+ *
+ * Ответы терминала сильнее оценок: они описывают реально подключённый
+ * терминал. Профиль, подтверждённый ответом, сохраняется в
+ * $XDG_CACHE_HOME/textui/terminal/<TERM>[+TERM_PROGRAM] (или
+ * ~/.cache/...). В кэш попадают только возможности вывода (REP, ECH/EL,
+ * truecolor): под одним TERM работают разные терминалы, и режимы,
+ * меняющие ввод или обрамление кадра (kitty, 2026, 2004, 1006), каждый
+ * запуск переспрашиваются коротким запросом - queryModes() с DA1 в
+ * конце. Терминал, не ответивший на DA1, опрашивается полностью при
+ * следующем запуске.
+ *
+ * Клавиши, нажатые за время запросов, теряются: опрос идёт один раз,
+ * до начала ввода.
+ */
+class TerminalProbe {
+public:
+    static constexpr int kQueryTimeoutMs = 150;
+    static constexpr int kCacheVersion = 2;
+
+    /**
+     * @brief Профиль текущего терминала (stdin/stdout)
+     * @param timeoutMs ожидание ответов; 0 (или TEXTUI_TERMINAL_PROBE=0
+     *        в окружении) - только TERM и terminfo, без запросов и кэша
+     */
+    static TerminalFeatures detect(int timeoutMs = kQueryTimeoutMs) {
+        TerminalFeatures features;
+#ifdef _WIN32
+        (void)timeoutMs;
+        features = TerminalFeatures::detect();
+#else
+        const char* probe = std::getenv("TEXTUI_TERMINAL_PROBE");
+        if (probe && std::string(probe) == "0") timeoutMs = 0;
+        std::string path = timeoutMs > 0 ? cachePath() : "";
+        if (!path.empty() && load(path, features)) {
+            // Без ответа режимы остаются выключенными: так безопаснее
+            queryModes(STDIN_FILENO, STDOUT_FILENO, timeoutMs, features);
+            return features;
+        }
+
+        features = TerminalFeatures::detect();
+        const char* term = std::getenv("TERM");
+        if (!term || !*term || std::string(term) == "dumb") return features;
+        readTerminfo(term, features);
+        if (timeoutMs > 0 && query(STDIN_FILENO, STDOUT_FILENO, timeoutMs, features) &&
+            !path.empty()) {
+            save(path, features);
+        }
+#endif
+        return features;
+    }
+
+    // Файл профиля для текущих TERM и TERM_PROGRAM ("" - негде хранить)
+    static std::string cachePath() {
+        const char* term = std::getenv("TERM");
+        if (!term || !*term) return "";
+        std::string key = term;
+        const char* program = std::getenv("TERM_PROGRAM");
+        if (program && *program) key += std::string("+") + program;
+        for (char& c : key) {
+            if (!isalnum(static_cast<unsigned char>(c)) && c != '-' && c != '_' && c != '.' && c != '+') {
+                c = '_';
+            }
+        }
+
+        const char* cache = std::getenv("XDG_CACHE_HOME");
+        const char* home = std::getenv("HOME");
+        std::string base;
+        if (cache && *cache) {
+            base = cache;
+        } else if (home && *home) {
+            base = std::string(home) + "/.cache";
+        } else {
+            return "";
+        }
+        return base + "/textui/terminal/" + key;
+    }
+
+    // Удалить сохранённый профиль (терминал обновился): следующий detect опросит заново
+    static bool clearCache() {
+        std::string path = cachePath();
+        std::error_code ec;
+        return !path.empty() && std::filesystem::remove(path, ec);
+    }
+
+    /**
+     * @brief Прочитать профиль из файла ("ключ = значение")
+     * Файл другой версии или с ошибкой не принимается.
+     */
+    static bool load(const std::string& path, TerminalFeatures& features) {
+        std::ifstream file(path);
+        if (!file) return false;
+        TerminalFeatures loaded;
+        bool versionOk = false;
+        std::string line;
+        while (std::getline(file, line)) {
+            size_t comment = line.find('#');
+            if (comment != std::string::npos) line.erase(comment);
+            size_t eq = line.find('=');
+            if (eq == std::string::npos) continue;
+            std::string key = trim(line.substr(0, eq));
+            std::string value = trim(line.substr(eq + 1));
+            if (key == "version") {
+                versionOk = value == std::to_string(kCacheVersion);
+                continue;
+            }
+            if (value != "0" && value != "1") return false;
+            bool* flag = field(loaded, key);
+            if (flag) *flag = value == "1";
+        }
+        if (!versionOk) return false;
+        features = loaded;
+        return true;
+    }
+
+    // Записать профиль (через временный файл: параллельный запуск не увидит половину)
+    static bool save(const std::string& path, const TerminalFeatures& features) {
+        std::error_code ec;
+        std::filesystem::path target(path);
+        std::filesystem::create_directories(target.parent_path(), ec);
+        if (ec) return false;
+
+        std::string temp = path + ".tmp" + std::to_string(static_cast<long>(getpid()));
+        {
+            std::ofstream file(temp, std::ios::trunc);
+            if (!file) return false;
+            file << "# textui terminal profile\n";
+            file << "version = " << kCacheVersion << "\n";
+            TerminalFeatures copy = features;
+            for (const char* name : kCachedFields) {
+                file << name << " = " << (*field(copy, name) ? 1 : 0) << "\n";
+            }
+            if (!file) return false;
+        }
+        std::filesystem::rename(temp, target, ec);
+        if (ec) {
+            std::filesystem::remove(temp, ec);
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Дополнить профиль из terminfo
+     *
+     * Читается скомпилированный файл (форматы ncurses с 16- и 32-битными
+     * числами) вместе с расширенными возможностями; libtinfo не нужна.
+     * @return false - описание не найдено
+     */
+    static bool readTerminfo(const std::string& term, TerminalFeatures& features) {
+        std::string data;
+        if (term.empty() || !loadTerminfo(term, data)) return false;
+
+        auto read16 = [&data](size_t pos) -> int {
+            if (pos + 2 > data.size()) return -1;
+            return static_cast<int16_t>(static_cast<uint8_t>(data[pos]) |
+                                        (static_cast<uint8_t>(data[pos + 1]) << 8));
+        };
+        auto stringAt = [&data](size_t pos) -> std::string {
+            return pos < data.size() ? std::string(data.c_str() + pos) : std::string();
+        };
+
+        int magic = read16(0);
+        if (magic != 0432 && magic != 01036) return false;
+        size_t numberSize = magic == 01036 ? 4 : 2;
+        int namesSize = read16(2);
+        int boolCount = read16(4);
+        int numCount = read16(6);
+        int strCount = read16(8);
+        int tableSize = read16(10);
+        if (namesSize < 0 || boolCount < 0 || numCount < 0 || strCount < 0 || tableSize < 0) return false;
+
+        size_t pos = 12 + static_cast<size_t>(namesSize);
+        size_t bools = pos;
+        pos += static_cast<size_t>(boolCount);
+        pos += pos & 1;
+        pos += static_cast<size_t>(numCount) * numberSize;
+        size_t strings = pos;
+        pos += static_cast<size_t>(strCount) * 2;
+        pos += static_cast<size_t>(tableSize);
+        if (pos > data.size()) return false;
+
+        if (boolCount > kBackColorErase && data[bools + kBackColorErase] == 1) features.erase = true;
+        if (strCount > kRepeatChar && read16(strings + 2 * kRepeatChar) >= 0 &&
+            !TerminalFeatures::repeatUnsupported()) {
+            features.repeat = true;
+        }
+
+        // Расширенные возможности: флаги, числа, строки, затем их имена
+        pos += pos & 1;
+        int extBools = read16(pos);
+        int extNums = read16(pos + 2);
+        int extStrs = read16(pos + 4);
+        int extTableSize = read16(pos + 8);
+        if (extBools < 0 || extNums < 0 || extStrs < 0 || extTableSize < 0) return true;
+        pos += 10;
+        size_t extBoolPos = pos;
+        pos += static_cast<size_t>(extBools);
+        pos += pos & 1;
+        size_t extNumPos = pos;
+        pos += static_cast<size_t>(extNums) * numberSize;
+        size_t extStrPos = pos;
+        pos += static_cast<size_t>(extStrs) * 2;
+        size_t namePos = pos;
+        int nameCount = extBools + extNums + extStrs;
+        pos += static_cast<size_t>(nameCount) * 2;
+        size_t table = pos;
+        if (table + static_cast<size_t>(extTableSize) > data.size()) return true;
+
+        // Имена лежат в таблице после последнего значения
+        size_t namesBase = 0;
+        for (int i = 0; i < extStrs; i++) {
+            int offset = read16(extStrPos + 2 * static_cast<size_t>(i));
+            if (offset < 0) continue;
+            size_t end = static_cast<size_t>(offset) + stringAt(table + offset).size() + 1;
+            namesBase = std::max(namesBase, end);
+        }
+
+        for (int i = 0; i < nameCount; i++) {
+            int nameOffset = read16(namePos + 2 * static_cast<size_t>(i));
+            if (nameOffset < 0) continue;
+            std::string name = stringAt(table + namesBase + nameOffset);
+            std::string value;
+            bool present;
+            if (i < extBools) {
+                present = data[extBoolPos + i] == 1;
+            } else if (i < extBools + extNums) {
+                // Старший байт отрицательного числа (нет значения) - 0xFF в обоих форматах
+                size_t at = extNumPos + static_cast<size_t>(i - extBools) * numberSize;
+                present = static_cast<uint8_t>(data[at + numberSize - 1]) != 0xFF;
+            } else {
+                int offset = read16(extStrPos + 2 * static_cast<size_t>(i - extBools - extNums));
+                present = offset >= 0;
+                if (present) value = stringAt(table + offset);
+            }
+            if (!present) continue;
+
+            if (name == "Tc" || name == "RGB") {
+                features.trueColor = true;
+            } else if (name == "Sync") {
+                features.synchronized = true;
+            } else if (name == "BE") {
+                features.bracketedPaste = true;
+            } else if (name == "XM" && value.find("1006") != std::string::npos) {
+                features.sgrMouse = true;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Применить ответы терминала на запросы query()
+     * @return true - среди ответов есть DA1 (терминал ответил на все)
+     */
+    static bool applyReplies(const std::string& replies, TerminalFeatures& features) {
+        bool primary = false;
+        size_t i = 0;
+        while (i < replies.size()) {
+            if (replies[i] != '\033' || i + 1 >= replies.size()) {
+                i++;
+                continue;
+            }
+
+            // DCS >|<имя> ST - XTVERSION
+            if (replies[i + 1] == 'P') {
+                size_t end = replies.find('\033', i + 2);
+                if (end == std::string::npos) break;
+                std::string body = replies.substr(i + 2, end - i - 2);
+                if (body.rfind(">|", 0) == 0) applyVersion(body.substr(2), features);
+                i = end + 1;
+                continue;
+            }
+            if (replies[i + 1] != '[') {
+                i++;
+                continue;
+            }
+
+            // CSI [?>] <числа;...> [$] <финал>
+            size_t p = i + 2;
+            char prefix = 0;
+            if (p < replies.size() && (replies[p] == '?' || replies[p] == '>')) prefix = replies[p++];
+            std::vector<int> params(1, 0);
+            while (p < replies.size() && (isdigit(static_cast<unsigned char>(replies[p])) || replies[p] == ';')) {
+                if (replies[p] == ';') {
+                    params.push_back(0);
+                } else {
+                    params.back() = params.back() * 10 + (replies[p] - '0');
+                }
+                p++;
+            }
+            bool dollar = p < replies.size() && replies[p] == '$';
+            if (dollar) p++;
+            if (p >= replies.size()) break;
+            char final = replies[p];
+            i = p + 1;
+
+            if (prefix == '?' && final == 'u') {
+                features.kittyKeyboard = true;
+            } else if (prefix == '?' && dollar && final == 'y' && params.size() >= 2) {
+                // DECRPM: 1, 2 - режим есть, 3 - включён всегда
+                bool known = params[1] >= 1 && params[1] <= 3;
+                if (params[0] == 2026) features.synchronized = known;
+                if (params[0] == 2004) features.bracketedPaste = known;
+                if (params[0] == 1006) features.sgrMouse = known;
+            } else if (prefix == '>' && final == 'c' && params.size() >= 2) {
+                // DA2: 41 - xterm, 1/65 с версией от 6200 - VTE
+                if (params[0] == 41 || ((params[0] == 1 || params[0] == 65) && params[1] >= 6200)) {
+                    features.repeat = true;
+                    features.erase = true;
+                }
+            } else if (prefix == '?' && final == 'c') {
+                primary = true;
+            }
+        }
+        return primary;
+    }
+
+#ifndef _WIN32
+    /**
+     * @brief Опросить терминал и дополнить профиль ответами
+     * @return true - терминал ответил (DA1) до таймаута
+     */
+    static bool query(int inFd, int outFd, int timeoutMs, TerminalFeatures& features) {
+        static const char kQueries[] =
+            "\033[?u"         // флаги клавиатуры kitty
+            "\033[?2026$p"    // DECRQM: синхронный вывод
+            "\033[?2004$p"    // вставка в скобках
+            "\033[?1006$p"    // мышь SGR
+            "\033[>0q"        // XTVERSION
+            "\033[>c"         // DA2
+            "\033[c";         // DA1 - последний
+        std::string replies;
+        if (!exchange(inFd, outFd, kQueries, timeoutMs, replies)) return false;
+        applyReplies(replies, features);
+        return true;
+    }
+
+    /**
+     * @brief Переспросить режимы, меняющие ввод и обрамление кадра
+     *
+     * Флаги kitty, 2026, 2004 и 1006 заменяются ответами терминала; без
+     * ответа (DA1 не пришёл) они сбрасываются. Остальной профиль не меняется.
+     * @return true - терминал ответил
+     */
+    static bool queryModes(int inFd, int outFd, int timeoutMs, TerminalFeatures& features) {
+        static const char kQueries[] =
+            "\033[?u"
+            "\033[?2026$p"
+            "\033[?2004$p"
+            "\033[?1006$p"
+            "\033[c";
+        features.kittyKeyboard = false;
+        features.synchronized = false;
+        features.bracketedPaste = false;
+        features.sgrMouse = false;
+        std::string replies;
+        if (!exchange(inFd, outFd, kQueries, timeoutMs, replies)) return false;
+        applyReplies(replies, features);
+        return true;
+    }
+#endif
+
+private:
+    // Номера стандартных возможностей в terminfo (term.h)
+    static constexpr int kBackColorErase = 28;   // bce
+    static constexpr int kRepeatChar = 121;      // rep
+
+    // Сохраняемые в кэш: не зависят от того, какой терминал стоит за TERM сейчас
+    static constexpr const char* kCachedFields[] = {"repeat", "erase", "truecolor"};
+
+#ifndef _WIN32
+    /**
+     * @brief Отправить запросы и собрать ответы до DA1
+     * На время опроса ввод переводится в неканонический режим без эха.
+     * @return true - терминал ответил (DA1) до таймаута
+     */
+    static bool exchange(int inFd, int outFd, const char* queries, int timeoutMs, std::string& replies) {
+        if (!isatty(inFd) || !isatty(outFd)) return false;
+
+        struct termios saved;
+        if (tcgetattr(inFd, &saved) != 0) return false;
+        struct termios raw = saved;
+        raw.c_lflag &= ~(ICANON | ECHO);
+        raw.c_cc[VMIN] = 0;
+        raw.c_cc[VTIME] = 0;
+        tcsetattr(inFd, TCSANOW, &raw);
+
+        bool sent = writeAll(outFd, queries, strlen(queries));
+
+        replies.clear();
+        bool primary = false;
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+        while (sent && !primary) {
+            auto left = std::chrono::duration_cast<std::chrono::microseconds>(
+                deadline - std::chrono::steady_clock::now()).count();
+            if (left <= 0) break;
+            fd_set fds;
+            FD_ZERO(&fds);
+            FD_SET(inFd, &fds);
+            struct timeval tv;
+            tv.tv_sec = static_cast<long>(left / 1000000);
+            tv.tv_usec = static_cast<long>(left % 1000000);
+            if (select(inFd + 1, &fds, nullptr, nullptr, &tv) <= 0) break;
+            char buf[512];
+            ssize_t n = read(inFd, buf, sizeof(buf));
+            if (n <= 0) break;
+            replies.append(buf, static_cast<size_t>(n));
+            TerminalFeatures scratch;
+            primary = applyReplies(replies, scratch);
+        }
+
+        tcsetattr(inFd, TCSANOW, &saved);
+        return primary;
+    }
+#endif
+
+    static bool* field(TerminalFeatures& features, const std::string& name) {
+        if (name == "repeat") return &features.repeat;
+        if (name == "erase") return &features.erase;
+        if (name == "synchronized") return &features.synchronized;
+        if (name == "truecolor") return &features.trueColor;
+        if (name == "bracketed_paste") return &features.bracketedPaste;
+        if (name == "kitty_keyboard") return &features.kittyKeyboard;
+        if (name == "sgr_mouse") return &features.sgrMouse;
+        return nullptr;
+    }
+
+    static std::string trim(const std::string& s) {
+        size_t b = 0;
+        size_t e = s.size();
+        while (b < e && isspace(static_cast<unsigned char>(s[b]))) b++;
+        while (e > b && isspace(static_cast<unsigned char>(s[e - 1]))) e--;
+        return s.substr(b, e - b);
+    }
+
+    // Терминалы, известные по XTVERSION
+    static void applyVersion(const std::string& version, TerminalFeatures& features) {
+        std::string name;
+        for (char c : version) name.push_back(static_cast<char>(tolower(static_cast<unsigned char>(c))));
+        auto startsWith = [&name](const char* prefix) { return name.rfind(prefix, 0) == 0; };
+
+        bool modern = startsWith("kitty") || startsWith("wezterm") || startsWith("foot") ||
+                      startsWith("ghostty") || startsWith("contour");
+        if (modern || startsWith("xterm(") || startsWith("tmux")) {
+            features.repeat = true;
+            features.erase = true;
+        }
+        if (modern || startsWith("iterm2")) features.trueColor = true;
+    }
+
+    static bool loadTerminfo(const std::string& term, std::string& data) {
+        if (term.find('/') != std::string::npos) return false;
+        std::vector<std::string> dirs;
+        if (const char* env = std::getenv("TERMINFO")) dirs.push_back(env);
+        if (const char* home = std::getenv("HOME")) dirs.push_back(std::string(home) + "/.terminfo");
+        if (const char* list = std::getenv("TERMINFO_DIRS")) {
+            std::stringstream entries(list);
+            std::string dir;
+            while (std::getline(entries, dir, ':')) {
+                if (!dir.empty()) dirs.push_back(dir);
+            }
+        }
+        for (const char* dir : {"/etc/terminfo", "/lib/terminfo", "/usr/share/terminfo",
+                                "/usr/lib/terminfo", "/usr/share/lib/terminfo"}) {
+            dirs.push_back(dir);
+        }
+
+        // Подкаталог - первая буква или её код (macOS)
+        char hex[3];
+        snprintf(hex, sizeof(hex), "%02x", static_cast<unsigned char>(term[0]));
+        for (const std::string& dir : dirs) {
+            for (const std::string& sub : {std::string(1, term[0]), std::string(hex)}) {
+                std::ifstream file(dir + "/" + sub + "/" + term, std::ios::binary);
+                if (!file) continue;
+                std::ostringstream content;
+                content << file.rdbuf();
+                data = content.str();
+                return true;
+            }
+        }
+        return false;
+    }
+
+#ifndef _WIN32
+    static bool writeAll(int fd, const char* data, size_t size) {
+        while (size > 0) {
+            ssize_t n = write(fd, data, size);
+            if (n <= 0) return false;
+            data += n;
+            size -= static_cast<size_t>(n);
+        }
+        return true;
+    }
+#endif
+};
+
+} // namespace ui
+
+#endif // TEXTUI_TERMINALPROBE_H
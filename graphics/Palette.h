@@ -0,0 +1,132 @@
+#ifndef TEXTUI_PALETTE_H
+#define TEXTUI_PALETTE_H
+
+#include "../graphics/Colors.h"
+#include <array>
+#include <cstddef>
+
+namespace ui {
+
+/**
+ * @brief Семантические роли цвета
+ *
+ * Виджеты рисуют ролями, ячейки экрана хранят роль, а конкретный
+ * стиль подставляется из палитры активной темы при выводе.
+ * Для каждого типа виджета идёт группа из 6 ролей в порядке
+ * полей WidgetColors: Normal, Focused, Disabled, Highlight, Text,
+ * Background.
+ */
+enum class ThemeRole : uint8_t {
+    ScreenBackground,
+    WindowBorder,
+    WindowTitle,
+    Hotkey,
+
+    WindowNormal, WindowFocused, WindowDisabled, WindowHighlight, WindowText, WindowBackground,
+    ButtonNormal, ButtonFocused, ButtonDisabled, ButtonHighlight, ButtonText, ButtonBackground,
+    LabelNormal, LabelFocused, LabelDisabled, LabelHighlight, LabelText, LabelBackground,
+    TextBoxNormal, TextBoxFocused, TextBoxDisabled, TextBoxHighlight, TextBoxText, TextBoxBackground,
+    MenuNormal, MenuFocused, MenuDisabled, MenuHighlight, MenuText, MenuBackground,
+    ListBoxNormal, ListBoxFocused, ListBoxDisabled, ListBoxHighlight, ListBoxText, ListBoxBackground,
+    CheckBoxNormal, CheckBoxFocused, CheckBoxDisabled, CheckBoxHighlight, CheckBoxText, CheckBoxBackground,
+    RadioNormal, RadioFocused, RadioDisabled, RadioHighlight, RadioText, RadioBackground,
+    TabNormal, TabFocused, TabDisabled, TabHighlight, TabText, TabBackground,
+    StatusBarNormal, StatusBarFocused, StatusBarDisabled, StatusBarHighlight, StatusBarText, StatusBarBackground,
+    DialogNormal, DialogFocused, DialogDisabled, DialogHighlight, DialogText, DialogBackground,
+    ErrorNormal, ErrorFocused, ErrorDisabled, ErrorHighlight, ErrorText, ErrorBackground,
+
+    Count
+};
+
+constexpr size_t kRoleCount = static_cast<size_t>(ThemeRole::Count);
+constexpr size_t kRoleGroupSize = 6;
+
+static_assert(kStyleCount + kRoleCount <= 0xFFFF, "role ids must fit into StyleId");
+
+// Роль в ячейке хранится как StyleId за пределами литеральных стилей
+constexpr StyleId roleStyleId(ThemeRole role) {
+    return static_cast<StyleId>(kStyleCount + static_cast<StyleId>(role));
+}
+
+constexpr bool isRoleStyle(StyleId id) { return id >= kStyleCount; }
+
+constexpr size_t styleRole(StyleId id) { return static_cast<size_t>(id - kStyleCount); }
+
+/**
+ * @brief Палитра: роль -> литеральный стиль
+ *
+ * Плоский массив, индексируемый ролью. Палитра по умолчанию
+ * повторяет цвета, которыми виджеты рисовались без тем.
+ */
+class Palette {
+private:
+    std::array<StyleId, kRoleCount> styles_{};
+
+    void setGroupIds(ThemeRole first, StyleId normal, StyleId focused, StyleId disabled,
+                     StyleId highlight, StyleId text, StyleId background) {
+        size_t i = static_cast<size_t>(first);
+        styles_[i + 0] = normal;
+        styles_[i + 1] = focused;
+        styles_[i + 2] = disabled;
+        styles_[i + 3] = highlight;
+        styles_[i + 4] = text;
+        styles_[i + 5] = background;
+    }
+
+public:
+    Palette() {
+        StyleId normal = ColorAttr::normal().styleId();
+        StyleId highlight = ColorAttr::highlight().styleId();
+        StyleId disabled = ColorAttr::biosDisabled().styleId();
+        StyleId black = ColorAttr(Color8::Black, Color8::Black).styleId();
+
+        for (ThemeRole group : {ThemeRole::WindowNormal, ThemeRole::ButtonNormal, ThemeRole::LabelNormal,
+                                ThemeRole::TextBoxNormal, ThemeRole::ListBoxNormal, ThemeRole::CheckBoxNormal,
+                                ThemeRole::RadioNormal, ThemeRole::ErrorNormal}) {
+            setGroupIds(group, normal, highlight, disabled, highlight, normal, black);
+        }
+
+        StyleId menu = ColorAttr::biosMenu().styleId();
+        StyleId selected = ColorAttr::biosSelected().styleId();
+        setGroupIds(ThemeRole::MenuNormal, menu, selected, disabled, selected, normal, black);
+        setGroupIds(ThemeRole::TabNormal, menu, selected, disabled, selected, normal, black);
+
+        StyleId bar = ColorAttr(Color8::Black, Color8::Gray).styleId();
+        StyleId barHighlight = ColorAttr(Color8::BrightWhite, Color8::Blue).styleId();
+        setGroupIds(ThemeRole::StatusBarNormal, bar, barHighlight, disabled, barHighlight, normal, black);
+
+        // Диалог: Highlight - кнопка, Focused - выбранная кнопка
+        setGroup(ThemeRole::DialogNormal,
+                 ColorAttr(Color8::BrightWhite, Color8::Blue),
+                 ColorAttr(Color8::BrightWhite, Color8::Blue),
+                 ColorAttr(Color8::Gray, Color8::Blue),
+                 ColorAttr(Color8::Black, Color8::Gray),
+                 ColorAttr(Color8::BrightWhite, Color8::Blue),
+                 ColorAttr(Color8::White, Color8::Blue));
+
+        set(ThemeRole::ScreenBackground, normal);
+        set(ThemeRole::WindowBorder, menu);
+        set(ThemeRole::WindowTitle, ColorAttr::biosTitle().styleId());
+        set(ThemeRole::Hotkey, TextStyle::biosHotkey().styleId());
+    }
+
+    StyleId operator[](ThemeRole role) const { return styles_[static_cast<size_t>(role)]; }
+    StyleId operator[](size_t role) const { return styles_[role]; }
+
+    void set(ThemeRole role, StyleId style) { styles_[static_cast<size_t>(role)] = style; }
+
+    // Задать группу из 6 ролей (first - роль Normal группы)
+    void setGroup(ThemeRole first, const ColorAttr& normal, const ColorAttr& focused,
+                  const ColorAttr& disabled, const ColorAttr& highlight,
+                  const ColorAttr& text, const ColorAttr& background) {
+        setGroupIds(first, normal.styleId(), focused.styleId(), disabled.styleId(),
+                    highlight.styleId(), text.styleId(), background.styleId());
+    }
+
+    bool operator==(const Palette& other) const { return styles_ == other.styles_; }
+    bool operator!=(const Palette& other) const { return !(*this == other); }
+};
+
+} // namespace ui
+
+#endif // TEXTUI_PALETTE_H
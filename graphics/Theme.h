@@ -3,7 +3,10 @@
 
 #include "../graphics/Colors.h"
 #include "../graphics/Chars.h"
+#include "../graphics/Palette.h"
 #include <string>
+#include <vector>
+#include <deque>
 #include <unordered_map>
 
 namespace ui {
@@ -77,6 +80,7 @@ public:
 
     // Геттеры
     const std::string& getName() const { return name_; }
+    void setName(const std::string& name) { name_ = name; }
     ThemeType getType() const { return type_; }
 
     const WidgetColors& getWindowColors() const { return windowColors_; }
@@ -112,6 +116,34 @@ public:
     void setBoxStyle(const BoxStyle& style) { boxStyle_ = style; }
     void setScreenBackground(const ColorAttr& bg) { screenBackground_ = bg; }
 
+    /**
+     * @brief Палитра ролей для Screen::setPalette
+     *
+     * Смена темы сводится к замене палитры: виджеты рисуют ролями
+     * и не перерисовываются.
+     */
+    Palette toPalette() const {
+        Palette palette;
+        auto group = [&palette](ThemeRole first, const WidgetColors& c) {
+            palette.setGroup(first, c.normal, c.focused, c.disabled, c.highlight, c.text, c.background);
+        };
+        group(ThemeRole::WindowNormal, windowColors_);
+        group(ThemeRole::ButtonNormal, buttonColors_);
+        group(ThemeRole::LabelNormal, labelColors_);
+        group(ThemeRole::TextBoxNormal, textBoxColors_);
+        group(ThemeRole::MenuNormal, menuColors_);
+        group(ThemeRole::ListBoxNormal, listBoxColors_);
+        group(ThemeRole::CheckBoxNormal, checkBoxColors_);
+        group(ThemeRole::RadioNormal, radioColors_);
+        group(ThemeRole::TabNormal, tabColors_);
+        group(ThemeRole::StatusBarNormal, statusBarColors_);
+        group(ThemeRole::DialogNormal, dialogColors_);
+        group(ThemeRole::ErrorNormal, errorColors_);
+        palette.set(ThemeRole::ScreenBackground, screenBackground_.styleId());
+        palette.set(ThemeRole::WindowBorder, windowColors_.normal.styleId());
+        return palette;
+    }
+
     // Предопределённые темы
     
     /**
@@ -354,60 +386,106 @@ public:
     }
 };
 
+// Индекс темы в ThemeManager
+using ThemeId = size_t;
+constexpr ThemeId kInvalidTheme = static_cast<ThemeId>(-1);
+
 /**
  * @brief Менеджер тем
+ *
+ * Темы хранятся по индексу (ThemeId) вместе со скомпилированной
+ * палитрой ролей; имя используется только для поиска индекса.
+ * Указатели на темы остаются действительными при добавлении
+ * новых тем и при замене темы с тем же именем.
  */
 class ThemeManager {
 private:
-    std::unordered_map<std::string, Theme> themes_;
-    Theme* currentTheme_ = nullptr;
+    struct Entry {
+        std::string key;
+        Theme theme;
+        Palette palette;   // скомпилированная таблица стилей
+    };
+
+    std::deque<Entry> entries_;
+    std::unordered_map<std::string, ThemeId> ids_;
+    ThemeId current_ = kInvalidTheme;
 
 public:
     ThemeManager() {
         // Регистрируем предопределённые темы
-        themes_["bios"] = Theme::createBIOS();
-        themes_["nc"] = Theme::createNortonCommander();
-        themes_["terminal"] = Theme::createTerminal();
-        themes_["mono"] = Theme::createMono();
+        addTheme("bios", Theme::createBIOS());
+        addTheme("nc", Theme::createNortonCommander());
+        addTheme("terminal", Theme::createTerminal());
+        addTheme("mono", Theme::createMono());
         
         // По умолчанию - BIOS тема
-        currentTheme_ = &themes_["bios"];
+        current_ = findTheme("bios");
+    }
+
+    // Индекс темы по имени (kInvalidTheme, если нет)
+    ThemeId findTheme(const std::string& name) const {
+        auto it = ids_.find(name);
+        return it != ids_.end() ? it->second : kInvalidTheme;
+    }
+
+    size_t getThemeCount() const { return entries_.size(); }
+
+    // Получить тему по индексу
+    Theme* getTheme(ThemeId id) {
+        return id < entries_.size() ? &entries_[id].theme : nullptr;
     }
 
     // Получить тему по имени
     Theme* getTheme(const std::string& name) {
-        auto it = themes_.find(name);
-        if (it != themes_.end()) {
-            return &it->second;
-        }
-        return nullptr;
+        return getTheme(findTheme(name));
     }
 
+    // Скомпилированная палитра темы (id должен быть действительным)
+    const Palette& getPalette(ThemeId id) const { return entries_[id].palette; }
+
     // Установить текущую тему
+    bool setTheme(ThemeId id) {
+        if (id >= entries_.size()) return false;
+        current_ = id;
+        return true;
+    }
+
     bool setTheme(const std::string& name) {
-        Theme* theme = getTheme(name);
-        if (theme) {
-            currentTheme_ = theme;
-            return true;
-        }
-        return false;
+        return setTheme(findTheme(name));
     }
 
     // Получить текущую тему
     Theme* getCurrentTheme() {
-        return currentTheme_;
+        return getTheme(current_);
     }
 
-    // Добавить пользовательскую тему
-    void addTheme(const std::string& name, const Theme& theme) {
-        themes_[name] = theme;
+    ThemeId getCurrentThemeId() const { return current_; }
+
+    /**
+     * @brief Добавить или заменить тему
+     *
+     * Тема с существующим именем заменяется на месте и сохраняет
+     * свой индекс. Палитра компилируется здесь, а не при отрисовке.
+     */
+    ThemeId addTheme(const std::string& name, const Theme& theme) {
+        ThemeId id = findTheme(name);
+        if (id == kInvalidTheme) {
+            id = entries_.size();
+            entries_.push_back(Entry{name, theme, theme.toPalette()});
+            ids_[name] = id;
+        } else {
+            entries_[id].theme = theme;
+            entries_[id].palette = theme.toPalette();
+        }
+        return id;
     }
 
-    // Список доступных тем
+    // Список доступных тем (в порядке индексов)
     std::vector<std::string> getThemeNames() const {
         std::vector<std::string> names;
-        for (const auto& pair : themes_) {
-            names.push_back(pair.first);
+        names.reserve(entries_.size());
+        for (const auto& entry : entries_) {
+            names.push_back(entry.key);
         }
         return names;
     }
@@ -0,0 +1,274 @@
+#ifndef TEXTUI_THEMEFILE_H
+#define TEXTUI_THEMEFILE_H
+
+#include "../graphics/Theme.h"
+#include <string>
+#include <fstream>
+#include <filesystem>
+#include <sstream>
+#include <cctype>
+#include <cstddef>
+
+namespace ui {
+
+/**
+ * @brief Загрузка темы из текстового файла
+ *
+ * Формат - строки "ключ = значение", комментарии начинаются с '#':
+ *
+ *     name   = Matrix
+ *     base   = terminal          # bios, nc, terminal, mono
+ *     box    = double            # thin, bold, double, mixed, ascii
+ *     screen = BrightGreen on Black
+ *     button.focused = Black on BrightGreen
+ *     dialog.background = White on Blue blink
+ *
+ * Группы: window, button, label, textbox, menu, listbox, checkbox,
+ * radio, tab, statusbar, dialog, error. Поля: normal, focused,
+ * disabled, highlight, text, background. Цвета - имена Color8 без
+ * учёта регистра или номера 0-15; яркий фон, как и в ColorAttr,
+ * приводится к тёмному (0-7).
+ *
+ * Ошибочный файл отвергается целиком: тема не меняется, причина
+ * возвращается в error ("строка: сообщение").
+ */
+class ThemeFile {
+public:
+    static constexpr size_t kMaxFileSize = 64 * 1024;
+
+private:
+    static std::string trim(const std::string& s) {
+        size_t b = 0;
+        size_t e = s.size();
+        while (b < e && isspace(static_cast<unsigned char>(s[b]))) b++;
+        while (e > b && isspace(static_cast<unsigned char>(s[e - 1]))) e--;
+        return s.substr(b, e - b);
+    }
+
+    static std::string toLower(std::string s) {
+        for (char& c : s) c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+        return s;
+    }
+
+    static bool parseColor(const std::string& word, int& out) {
+        static const char* const names[16] = {
+            "black", "blue", "green", "cyan", "red", "magenta", "brown", "white",
+            "gray", "brightblue", "brightgreen", "brightcyan",
+            "brightred", "brightmagenta", "brightyellow", "brightwhite"};
+        std::string lower = toLower(word);
+        for (int i = 0; i < 16; i++) {
+            if (lower == names[i]) {
+                out = i;
+                return true;
+            }
+        }
+        if (lower == "yellow") {
+            out = static_cast<int>(Color8::BrightYellow);
+            return true;
+        }
+        if (!lower.empty() && lower.size() <= 2 &&
+            isdigit(static_cast<unsigned char>(lower[0])) &&
+            (lower.size() == 1 || isdigit(static_cast<unsigned char>(lower[1])))) {
+            out = std::stoi(lower);
+            return out < 16;
+        }
+        return false;
+    }
+
+    // "<fg> [on <bg>] [blink]"
+    static bool parseAttr(const std::string& value, ColorAttr& out, std::string& error) {
+        std::istringstream words(value);
+        std::string word;
+        int fg = -1;
+        int bg = static_cast<int>(Color8::Black);
+        bool blink = false;
+
+        if (!(words >> word) || !parseColor(word, fg)) {
+            error = "unknown color '" + word + "'";
+            return false;
+        }
+        while (words >> word) {
+            std::string lower = toLower(word);
+            if (lower == "on") {
+                if (!(words >> word) || !parseColor(word, bg)) {
+                    error = "unknown background '" + word + "'";
+                    return false;
+                }
+            } else if (lower == "blink") {
+                blink = true;
+            } else {
+                error = "unexpected '" + word + "'";
+                return false;
+            }
+        }
+        out = ColorAttr(static_cast<Color8>(fg), static_cast<Color8>(bg), blink);
+        return true;
+    }
+
+    static bool parseBase(const std::string& value, Theme& theme) {
+        std::string lower = toLower(value);
+        if (lower == "bios") theme = Theme::createBIOS();
+        else if (lower == "nc") theme = Theme::createNortonCommander();
+        else if (lower == "terminal") theme = Theme::createTerminal();
+        else if (lower == "mono") theme = Theme::createMono();
+        else return false;
+        return true;
+    }
+
+    static bool parseBox(const std::string& value, BoxStyle& out) {
+        std::string lower = toLower(value);
+        if (lower == "thin") out = BoxStyles::thin();
+        else if (lower == "bold") out = BoxStyles::bold();
+        else if (lower == "double") out = BoxStyles::doubleLine();
+        else if (lower == "mixed") out = BoxStyles::mixed();
+        else if (lower == "ascii") out = BoxStyles::ascii();
+        else return false;
+        return true;
+    }
+
+    // Поле WidgetColors по имени
+    static ColorAttr* field(WidgetColors& colors, const std::string& name) {
+        if (name == "normal") return &colors.normal;
+        if (name == "focused") return &colors.focused;
+        if (name == "disabled") return &colors.disabled;
+        if (name == "highlight") return &colors.highlight;
+        if (name == "text") return &colors.text;
+        if (name == "background") return &colors.background;
+        return nullptr;
+    }
+
+    // Установить "группа.поле"
+    static bool setGroupField(Theme& theme, const std::string& key, const ColorAttr& attr) {
+        size_t dot = key.find('.');
+        if (dot == std::string::npos) return false;
+        std::string group = key.substr(0, dot);
+        std::string name = key.substr(dot + 1);
+
+        using Getter = const WidgetColors& (Theme::*)() const;
+        using Setter = void (Theme::*)(const WidgetColors&);
+        struct Group { const char* name; Getter get; Setter set; };
+        static const Group groups[] = {
+            {"window", &Theme::getWindowColors, &Theme::setWindowColors},
+            {"button", &Theme::getButtonColors, &Theme::setButtonColors},
+            {"label", &Theme::getLabelColors, &Theme::setLabelColors},
+            {"textbox", &Theme::getTextBoxColors, &Theme::setTextBoxColors},
+            {"menu", &Theme::getMenuColors, &Theme::setMenuColors},
+            {"listbox", &Theme::getListBoxColors, &Theme::setListBoxColors},
+            {"checkbox", &Theme::getCheckBoxColors, &Theme::setCheckBoxColors},
+            {"radio", &Theme::getRadioColors, &Theme::setRadioColors},
+            {"tab", &Theme::getTabColors, &Theme::setTabColors},
+            {"statusbar", &Theme::getStatusBarColors, &Theme::setStatusBarColors},
+            {"dialog", &Theme::getDialogColors, &Theme::setDialogColors},
+            {"error", &Theme::getErrorColors, &Theme::setErrorColors},
+        };
+
+        for (const Group& g : groups) {
+            if (group != g.name) continue;
+            WidgetColors colors = (theme.*g.get)();
+            ColorAttr* target = field(colors, name);
+            if (!target) return false;
+            *target = attr;
+            (theme.*g.set)(colors);
+            return true;
+        }
+        return false;
+    }
+
+public:
+    /**
+     * @brief Разобрать текст темы
+     * Имя theme остаётся именем по умолчанию, если в файле нет "name".
+     * @return true, если разбор успешен (тогда theme заменяется)
+     */
+    static bool parse(const std::string& text, Theme& theme, std::string& error) {
+        Theme result(theme.getName(), ThemeType::Custom);
+        std::istringstream lines(text);
+        std::string line;
+        int lineNo = 0;
+        bool seenColors = false;
+
+        auto fail = [&](const std::string& message) {
+            error = std::to_string(lineNo) + ": " + message;
+            return false;
+        };
+
+        while (std::getline(lines, line)) {
+            lineNo++;
+            size_t hash = line.find('#');
+            if (hash != std::string::npos) line.erase(hash);
+            line = trim(line);
+            if (line.empty()) continue;
+
+            size_t eq = line.find('=');
+            if (eq == std::string::npos) return fail("expected 'key = value'");
+            std::string key = toLower(trim(line.substr(0, eq)));
+            std::string value = trim(line.substr(eq + 1));
+            if (value.empty()) return fail("empty value for '" + key + "'");
+
+            if (key == "base") {
+                // base сбрасывает цвета, поэтому идёт раньше них
+                if (seenColors) return fail("'base' must come before colors");
+                std::string name = result.getName();
+                if (!parseBase(value, result)) return fail("unknown base theme '" + value + "'");
+                result.setName(name);
+            } else if (key == "name") {
+                result.setName(value);
+            } else if (key == "box") {
+                seenColors = true;
+                BoxStyle box = BoxStyles::thin();
+                if (!parseBox(value, box)) return fail("unknown box style '" + value + "'");
+                result.setBoxStyle(box);
+            } else {
+                seenColors = true;
+                ColorAttr attr;
+                std::string attrError;
+                if (!parseAttr(value, attr, attrError)) return fail(attrError);
+                if (key == "screen") {
+                    result.setScreenBackground(attr);
+                } else if (!setGroupField(result, key, attr)) {
+                    return fail("unknown key '" + key + "'");
+                }
+            }
+        }
+
+        theme = result;
+        return true;
+    }
+
+    /**
+     * @brief Прочитать и разобрать файл темы
+     *
+     * Читает только обычные файлы не больше kMaxFileSize: открытие
+     * FIFO или устройства заблокировало бы вызывающий поток.
+     */
+    static bool load(const std::string& path, Theme& theme, std::string& error) {
+        std::error_code ec;
+        if (!std::filesystem::is_regular_file(path, ec)) {
+            error = path + ": not a regular file";
+            return false;
+        }
+        std::ifstream in(path, std::ios::binary);
+        if (!in) {
+            error = "cannot open " + path;
+            return false;
+        }
+        std::string text;
+        char buffer[4096];
+        while (in.read(buffer, sizeof(buffer)) || in.gcount() > 0) {
+            text.append(buffer, static_cast<size_t>(in.gcount()));
+            if (text.size() > kMaxFileSize) {
+                error = path + ": file too large";
+                return false;
+            }
+        }
+        if (!parse(text, theme, error)) {
+            error = path + ":" + error;
+            return false;
+        }
+        return true;
+    }
+};
+
+} // namespace ui
+
+#endif // TEXTUI_THEMEFILE_H
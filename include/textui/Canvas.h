@@ -0,0 +1,229 @@
+#ifndef TEXTUI_CANVAS_H
+#define TEXTUI_CANVAS_H
+
+#include "Widget.h"
+#include "../core/Screen.h"
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace ui {
+
+/**
+ * @brief Холст с сеткой точек 2x4 в каждой ячейке
+ *
+ * Точки хранятся упакованно: байт на ячейку, бит на точку. Рисование
+ * меняет только биты и отмечает ячейку в маске изменённых. Полная
+ * отрисовка (draw) выводит все ячейки; после App::invalidate(canvas)
+ * drawChanges выводит только отмеченные.
+ *
+ * Ячейка экрана - один байт CP437, поэтому узор выводится ближайшим
+ * символом из полублоков и линий (glyphFor): на экране форма читается
+ * с точностью до половины ячейки, тонкие линии - до строки точек.
+ * Сетка точек нужна для рисования и test(); видимого разрешения выше
+ * полублока она не даёт. Размер холста задаётся при создании.
+ *
+ *     auto* canvas = app.addCanvas(window, 2, 2, 60, 15);   // 120x60 точек
+ *     canvas->line(0, 59, 119, 0);
+ *     canvas->setPen(ThemeRole::ErrorText);
+ *     canvas->point(60, 30);
+ */
+class Canvas : public Widget {
+private:
+    int columns_;
+    int rows_;
+    std::vector<uint8_t> dots_;         // узор ячейки (kDotBits)
+    std::vector<StyleId> styles_;       // цвет ячейки: перо последней точки
+    std::vector<uint64_t> dirty_;       // ячейки, изменённые после отрисовки
+    StyleId pen_ = roleStyleId(ThemeRole::LabelHighlight);
+
+    // Бит точки (x & 1, y & 3) в ячейке
+    static constexpr uint8_t kDotBits[4][2] = {
+        {0x01, 0x08}, {0x02, 0x10}, {0x04, 0x20}, {0x40, 0x80}};
+
+    static unsigned lowestBit(uint64_t mask) {
+#ifdef _MSC_VER
+        unsigned long idx;
+        _BitScanForward64(&idx, mask);
+        return static_cast<unsigned>(idx);
+#else
+        return static_cast<unsigned>(__builtin_ctzll(mask));
+#endif
+    }
+
+    void markDirty(size_t cell) { dirty_[cell >> 6] |= uint64_t(1) << (cell & 63); }
+
+    void plot(int x, int y, bool on) {
+        if (x < 0 || y < 0 || x >= columns_ * 2 || y >= rows_ * 4) return;
+        size_t cell = static_cast<size_t>(y >> 2) * columns_ + static_cast<size_t>(x >> 1);
+        uint8_t bit = kDotBits[y & 3][x & 1];
+        uint8_t dots = on ? (dots_[cell] | bit) : (dots_[cell] & ~bit);
+        if (dots == dots_[cell] && (!on || styles_[cell] == pen_)) return;
+        dots_[cell] = dots;
+        if (on) styles_[cell] = pen_;
+        markDirty(cell);
+    }
+
+    template <class Fn>
+    static void rasterLine(int x0, int y0, int x1, int y1, Fn fn) {
+        int dx = std::abs(x1 - x0);
+        int dy = -std::abs(y1 - y0);
+        int sx = x0 < x1 ? 1 : -1;
+        int sy = y0 < y1 ? 1 : -1;
+        int err = dx + dy;
+        for (;;) {
+            fn(x0, y0);
+            if (x0 == x1 && y0 == y1) return;
+            int e2 = 2 * err;
+            if (e2 >= dy) {
+                err += dy;
+                x0 += sx;
+            }
+            if (e2 <= dx) {
+                err += dx;
+                y0 += sy;
+            }
+        }
+    }
+
+public:
+    Canvas(int x, int y, int width, int height)
+        : Widget(x, y, width, height),
+          columns_(width > 0 ? width : 0),
+          rows_(height > 0 ? height : 0),
+          dots_(static_cast<size_t>(columns_) * rows_, 0),
+          styles_(dots_.size(), roleStyleId(ThemeRole::LabelNormal)),
+          dirty_((dots_.size() + 63) / 64, 0) {
+        canFocus_ = false;
+    }
+
+    // Размер в точках
+    int dotWidth() const { return columns_ * 2; }
+    int dotHeight() const { return rows_ * 4; }
+
+    // Цвет следующих точек (ячейка берёт цвет последней точки)
+    void setPen(StyleId style) { pen_ = style; }
+    void setPen(ThemeRole role) { pen_ = roleStyleId(role); }
+    void setPen(const ColorAttr& color) { pen_ = color.styleId(); }
+
+    // Точки за пределами холста пропускаются
+    void point(int x, int y) { plot(x, y, true); }
+    void erase(int x, int y) { plot(x, y, false); }
+
+    bool test(int x, int y) const {
+        if (x < 0 || y < 0 || x >= columns_ * 2 || y >= rows_ * 4) return false;
+        return dots_[static_cast<size_t>(y >> 2) * columns_ + static_cast<size_t>(x >> 1)] &
+               kDotBits[y & 3][x & 1];
+    }
+
+    // Отрезок (Брезенхэм), концы включительно
+    void line(int x0, int y0, int x1, int y1) {
+        rasterLine(x0, y0, x1, y1, [this](int x, int y) { plot(x, y, true); });
+    }
+
+    void rect(int x, int y, int w, int h) {
+        if (w <= 0 || h <= 0) return;
+        line(x, y, x + w - 1, y);
+        line(x, y + h - 1, x + w - 1, y + h - 1);
+        line(x, y, x, y + h - 1);
+        line(x + w - 1, y, x + w - 1, y + h - 1);
+    }
+
+    void clear() {
+        for (size_t cell = 0; cell < dots_.size(); cell++) {
+            if (dots_[cell]) {
+                dots_[cell] = 0;
+                markDirty(cell);
+            }
+        }
+    }
+
+    // Узор ячейки (биты kDotBits)
+    uint8_t pattern(int column, int row) const {
+        return dots_[static_cast<size_t>(row) * columns_ + column];
+    }
+
+    /**
+     * @brief Символ CP437 для узора ячейки
+     *
+     * Ближайший по числу несовпавших точек из пустой ячейки, полного
+     * блока, полублоков и линий ' - _ / \ ─; при равенстве непустой
+     * узор получает непустой символ. Таблица строится один раз.
+     */
+    static char glyphFor(uint8_t dots) {
+        static const std::array<char, 256> table = [] {
+            struct Candidate { char glyph; uint8_t dots; };
+            const Candidate candidates[] = {
+                {' ', 0x00}, {'\xDB', 0xFF}, {'\xDF', 0x1B}, {'\xDC', 0xE4},
+                {'\xDD', 0x47}, {'\xDE', 0xB8}, {'\'', 0x09}, {'\xC4', 0x12},
+                {'-', 0x24}, {'_', 0xC0}, {'/', 0x5C}, {'\\', 0xA3}};
+            std::array<char, 256> result{};
+            for (int mask = 0; mask < 256; mask++) {
+                int best = -1;
+                int bestDistance = 9;
+                for (int i = 0; i < static_cast<int>(sizeof(candidates) / sizeof(candidates[0])); i++) {
+                    int distance = 0;
+                    for (int diff = mask ^ candidates[i].dots; diff; diff &= diff - 1) distance++;
+                    bool tieWithBlank = best == 0 && distance == bestDistance && mask != 0;
+                    if (distance < bestDistance || tieWithBlank) {
+                        best = i;
+                        bestDistance = distance;
+                    }
+                }
+                result[static_cast<size_t>(mask)] = candidates[best].glyph;
+            }
+            return result;
+        }();
+        return table[dots];
+    }
+
+    // Все ячейки: окно под холстом перерисовано
+    void draw(Screen& screen) override {
+        if (!visible_) return;
+        std::fill(dirty_.begin(), dirty_.end(), 0);
+        int fromX = x_ < 0 ? -x_ : 0;
+        int fromY = y_ < 0 ? -y_ : 0;
+        int toX = std::min(columns_, screen.getWidth() - x_);
+        int toY = std::min(rows_, screen.getHeight() - y_);
+        for (int row = fromY; row < toY; row++) {
+            for (int column = fromX; column < toX; column++) {
+                putCell(screen, static_cast<size_t>(row) * columns_ + column);
+            }
+        }
+    }
+
+    // Только ячейки, изменённые после прошлой отрисовки
+    void drawChanges(Screen& screen) override {
+        if (!visible_) return;
+        for (size_t word = 0; word < dirty_.size(); word++) {
+            for (uint64_t mask = dirty_[word]; mask; mask &= mask - 1) {
+                size_t cell = word * 64 + lowestBit(mask);
+                if (cell >= dots_.size()) break;
+                putCell(screen, cell);
+            }
+            dirty_[word] = 0;
+        }
+    }
+
+private:
+    void putCell(Screen& screen, size_t cell) {
+        int sx = x_ + static_cast<int>(cell % static_cast<size_t>(columns_));
+        int sy = y_ + static_cast<int>(cell / static_cast<size_t>(columns_));
+        if (sx < 0 || sy < 0 || sx >= screen.getWidth() || sy >= screen.getHeight()) return;
+        char ch = glyphFor(dots_[cell]);
+        StyleId style = (ch == ' ' || !enabled_)
+            ? roleStyleId(enabled_ ? ThemeRole::LabelNormal : ThemeRole::LabelDisabled)
+            : styles_[cell];
+        screen.putChar(sx, sy, ch, style);
+    }
+};
+
+} // namespace ui
+
+#endif // TEXTUI_CANVAS_H
@@ -133,6 +133,11 @@ namespace Symbols {
     inline const char* progressHalf = "\xB1";   // 177 - средняя штриховка
     inline const char* progressEmpty = "\xB0";  // 176 - лёгкая штриховка
     
+    // Блоки графиков: в ячейке две ступени по высоте
+    inline const char* blockFull = "\xDB";     // 219 - полный блок
+    inline const char* blockLower = "\xDC";    // 220 - нижняя половина
+    inline const char* blockUpper = "\xDF";    // 223 - верхняя половина
+
     // Разделители
     inline const char* separatorH = "\xC4";     // 196
     inline const char* separatorV = "\xB3";     // 179
@@ -0,0 +1,176 @@
+#ifndef TEXTUI_CHART_H
+#define TEXTUI_CHART_H
+
+#include "Widget.h"
+#include "../core/Screen.h"
+#include "../core/SpscRing.h"
+#include <deque>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+namespace ui {
+
+/**
+ * @brief График потока отсчётов (высота 1 - sparkline)
+ *
+ * Сборщик метрик в своём потоке кладёт отсчёты push() в кольцевой
+ * буфер без блокировок. Поток интерфейса забирает их update():
+ * каждые samplesPerColumn отсчётов сворачиваются в столбец (минимум
+ * и максимум), на экране - последние width столбцов, новый справа.
+ * update() возвращает true, только когда готов новый столбец, -
+ * перерисовка не чаще, чем растёт график:
+ *
+ *     auto* chart = app.addChart(window, 2, 2, 60, 8);
+ *     chart->setSamplesPerColumn(100);
+ *     app.watch(chart, 50, [chart] { return chart->update(); });
+ *     // поток сборщика
+ *     chart->push(latencyMs);
+ *
+ * Столбец рисуется от минимума до максимума (setFilled - от низа до
+ * максимума) полублоками: две ступени на строку.
+ */
+class Chart : public Widget {
+public:
+    static constexpr size_t kDefaultCapacity = 8192;   // отсчётов в буфере
+
+private:
+    struct Column {
+        double min;
+        double max;
+    };
+
+    SpscRing<double> samples_;
+
+    // Только поток интерфейса
+    std::deque<Column> columns_;
+    size_t samplesPerColumn_ = 1;
+    size_t bucketCount_ = 0;
+    uint64_t completed_ = 0;      // столбцов готово за всё время
+    double bucketMin_ = 0;
+    double bucketMax_ = 0;
+    bool autoRange_ = true;
+    double rangeMin_ = 0;
+    double rangeMax_ = 1;
+    bool filled_ = false;
+
+    void addSample(double value) {
+        if (value != value) return;   // NaN - пропуск
+        if (bucketCount_ == 0) {
+            bucketMin_ = bucketMax_ = value;
+        } else {
+            bucketMin_ = std::min(bucketMin_, value);
+            bucketMax_ = std::max(bucketMax_, value);
+        }
+        if (++bucketCount_ < samplesPerColumn_) return;
+        columns_.push_back({bucketMin_, bucketMax_});
+        while (columns_.size() > static_cast<size_t>(std::max(1, width_))) columns_.pop_front();
+        bucketCount_ = 0;
+        completed_++;
+    }
+
+public:
+    Chart(int x, int y, int width, int height, size_t capacity = kDefaultCapacity)
+        : Widget(x, y, width, height), samples_(capacity) {
+        canFocus_ = false;
+    }
+
+    // Поток-писатель (один): false - буфер полон, отсчёт потерян
+    bool push(double value) { return samples_.push(value); }
+
+    /**
+     * @brief Забрать отсчёты из буфера (поток интерфейса)
+     * @return true - готов хотя бы один новый столбец
+     */
+    bool update() {
+        uint64_t before = completed_;
+        samples_.consume([this](double value) { addSample(value); });
+        return completed_ != before;
+    }
+
+    // Отсчётов в столбце (начатый столбец сбрасывается)
+    void setSamplesPerColumn(size_t count) {
+        samplesPerColumn_ = count > 0 ? count : 1;
+        bucketCount_ = 0;
+    }
+
+    size_t getSamplesPerColumn() const { return samplesPerColumn_; }
+
+    // Показать последние samples отсчётов на всю ширину
+    void setWindow(size_t samples) {
+        size_t columns = static_cast<size_t>(std::max(1, width_));
+        setSamplesPerColumn((samples + columns - 1) / columns);
+    }
+
+    // Шкала: постоянная или по видимым столбцам (по умолчанию)
+    void setRange(double min, double max) {
+        rangeMin_ = min;
+        rangeMax_ = max;
+        autoRange_ = false;
+    }
+
+    void setAutoRange() { autoRange_ = true; }
+    bool isAutoRange() const { return autoRange_; }
+
+    // Заливка от низа до максимума вместо полосы минимум-максимум
+    void setFilled(bool filled) { filled_ = filled; }
+    bool isFilled() const { return filled_; }
+
+    // Стереть график (поток интерфейса; буфер остаётся)
+    void clear() {
+        columns_.clear();
+        bucketCount_ = 0;
+    }
+
+    size_t getColumnCount() const { return columns_.size(); }
+    uint64_t getDropped() const { return samples_.getDropped(); }
+
+    void draw(Screen& screen) override {
+        if (!visible_ || width_ <= 0 || height_ <= 0) return;
+
+        ThemeRole background = enabled_ ? ThemeRole::LabelNormal : ThemeRole::LabelDisabled;
+        ThemeRole bar = enabled_ ? ThemeRole::LabelHighlight : ThemeRole::LabelDisabled;
+        screen.fillRect(x_, y_, width_, height_, ' ', background);
+        if (columns_.empty()) return;
+
+        size_t count = std::min(columns_.size(), static_cast<size_t>(width_));
+        size_t first = columns_.size() - count;
+        double low = rangeMin_;
+        double high = rangeMax_;
+        if (autoRange_) {
+            low = columns_[first].min;
+            high = columns_[first].max;
+            for (size_t i = first + 1; i < columns_.size(); i++) {
+                low = std::min(low, columns_[i].min);
+                high = std::max(high, columns_[i].max);
+            }
+        }
+        if (!(high > low)) high = low + 1;
+
+        // Ступени снизу: 2 на строку
+        int levels = height_ * 2;
+        double scale = levels / (high - low);
+        auto levelOf = [&](double value) {
+            double level = (value - low) * scale;
+            if (!(level > 0)) return 0;
+            return level >= levels ? levels - 1 : static_cast<int>(level);
+        };
+
+        int x = x_ + width_ - static_cast<int>(count);
+        for (size_t i = first; i < columns_.size(); i++, x++) {
+            int bottom = filled_ ? 0 : levelOf(columns_[i].min);
+            int top = levelOf(columns_[i].max);
+            for (int row = bottom / 2; row <= top / 2; row++) {
+                bool lower = 2 * row >= bottom;
+                bool upper = 2 * row + 1 <= top;
+                const char* glyph = lower && upper ? Symbols::blockFull
+                                  : lower ? Symbols::blockLower : Symbols::blockUpper;
+                screen.putString(x, y_ + height_ - 1 - row, glyph, bar);
+            }
+        }
+    }
+};
+
+} // namespace ui
+
+#endif // TEXTUI_CHART_H
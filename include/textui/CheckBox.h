@@ -70,9 +70,9 @@ public:
     void draw(Screen& screen) override {
         if (!visible_) return;
 
-        ColorAttr normalColor = enabled_ ? ColorAttr::normal() : ColorAttr::biosDisabled();
-        ColorAttr focusColor = enabled_ ? ColorAttr::highlight() : ColorAttr::biosDisabled();
-        ColorAttr color = hasFocus_ ? focusColor : normalColor;
+        ThemeRole normalColor = enabled_ ? ThemeRole::CheckBoxNormal : ThemeRole::CheckBoxDisabled;
+        ThemeRole focusColor = enabled_ ? ThemeRole::CheckBoxFocused : ThemeRole::CheckBoxDisabled;
+        ThemeRole color = hasFocus_ ? focusColor : normalColor;
 
         // Р РёСЃСѓРµРј [X] РёР»Рё [ ]
         const char* checkStr = checked_ ? Symbols::checkboxOn : Symbols::checkboxOff;
@@ -82,7 +82,7 @@ public:
             std::string hotkeyText = "[";
             hotkeyText += static_cast<char>(toupper(hotkey_));
             hotkeyText += "]";
-            screen.putString(x_, y_, hotkeyText.c_str(), TextStyle::biosHotkey());
+            screen.putString(x_, y_, hotkeyText.c_str(), ThemeRole::Hotkey);
             screen.putString(x_ + 3, y_, checkStr, color);
             screen.putString(x_ + 7, y_, text_.c_str(), color);
         } else {
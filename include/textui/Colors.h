@@ -56,6 +56,33 @@ inline TextAttr& operator|=(TextAttr& a, TextAttr b) {
     return a;
 }
 
+/**
+ * @brief Идентификатор стиля ячейки
+ *
+ * Биты: 0-3 цвет текста, 4-6 цвет фона, 7 bold, 8 underline,
+ * 9 inverse, 10 blink. Все 2048 стилей имеют готовые
+ * SGR-последовательности (core/Sgr.h).
+ */
+using StyleId = uint16_t;
+
+constexpr StyleId kStyleCount = 2048;
+
+namespace StyleFlags {
+    constexpr StyleId Bold      = 1 << 7;
+    constexpr StyleId Underline = 1 << 8;
+    constexpr StyleId Inverse   = 1 << 9;
+    constexpr StyleId Blink     = 1 << 10;
+    constexpr StyleId Mask      = Bold | Underline | Inverse | Blink;
+}
+
+constexpr StyleId makeStyleId(uint8_t fg, uint8_t bg, StyleId flags = 0) {
+    return static_cast<StyleId>((fg & 0x0F) | ((bg & 0x07) << 4) | (flags & StyleFlags::Mask));
+}
+
+constexpr uint8_t styleFg(StyleId id) { return id & 0x0F; }
+constexpr uint8_t styleBg(StyleId id) { return (id >> 4) & 0x07; }
+constexpr StyleId styleFlags(StyleId id) { return id & StyleFlags::Mask; }
+
 /**
  * @brief Цветовой атрибут BIOS (1 байт)
  * 
@@ -88,6 +115,11 @@ struct ColorAttr {
         return c;
     }
 
+    // Идентификатор стиля (без атрибутов текста)
+    StyleId styleId() const {
+        return makeStyleId(fg, bg, blink ? StyleFlags::Blink : 0);
+    }
+
     // Предопределённые цвета
     static ColorAttr normal() { return ColorAttr(Color8::White, Color8::Black); }
     static ColorAttr highlight() { return ColorAttr(Color8::Black, Color8::White); }
@@ -121,6 +153,16 @@ struct TextStyle {
     
     TextStyle(ColorAttr c, TextAttr a) : color(c), attr(a) {}
 
+    // Идентификатор стиля с атрибутами
+    StyleId styleId() const {
+        StyleId flags = 0;
+        if ((attr & TextAttr::Bold) != TextAttr::None) flags |= StyleFlags::Bold;
+        if ((attr & TextAttr::Underline) != TextAttr::None) flags |= StyleFlags::Underline;
+        if ((attr & TextAttr::Inverse) != TextAttr::None) flags |= StyleFlags::Inverse;
+        if (color.blink || (attr & TextAttr::Blink) != TextAttr::None) flags |= StyleFlags::Blink;
+        return makeStyleId(color.fg, color.bg, flags);
+    }
+
     // Предопределённые стили
     static TextStyle normal() { return TextStyle(ColorAttr::normal()); }
     static TextStyle bold() { 
@@ -0,0 +1,657 @@
+#ifndef TEXTUI_DATAGRID_H
+#define TEXTUI_DATAGRID_H
+
+#include "Widget.h"
+#include "../core/Screen.h"
+#include "../core/ThreadPool.h"
+#include <string>
+#include <vector>
+#include <functional>
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <cstdint>
+#include <cstdio>
+
+namespace ui {
+
+// Тип данных колонки
+enum class ColumnType {
+    Int,        // int64_t
+    Double,     // double
+    Text        // std::string
+};
+
+/**
+ * @brief Таблица с колоночным хранением и виртуальной прокруткой
+ *
+ * Данные хранятся по колонкам в типизированных массивах, числа
+ * остаются числами. Сортировка переставляет только индексы строк
+ * (order_), большие таблицы сортируются параллельно на общем пуле.
+ * Рисуются лишь видимые строки; заголовок закреплён сверху.
+ * Автоширина колонки считается при отрисовке по выборке строк
+ * и только после изменения данных этой колонки.
+ */
+class DataGrid : public Widget {
+public:
+    static constexpr size_t kSortChunk = 65536;     // строк на поток при сортировке
+    static constexpr size_t kRadixMin = 256;        // меньшие группы - сортировка сравнением
+    static constexpr size_t kWidthSample = 256;     // строк в выборке для автоширины
+    static constexpr int kMaxAutoWidth = 32;
+
+private:
+    struct Column {
+        std::string title;
+        ColumnType type = ColumnType::Text;
+        int fixedWidth = 0;        // 0 - автоширина
+        int precision = 2;         // знаков после запятой для Double
+        int autoWidth = 0;
+        bool widthDirty = true;
+        std::vector<int64_t> ints;
+        std::vector<double> reals;
+        std::vector<std::string> texts;
+    };
+
+    // Ключ сортировки: 8 байт, сравниваемых как беззнаковое число
+    struct SortKey {
+        uint64_t key;
+        uint32_t row;
+    };
+
+    std::vector<Column> columns_;
+    std::vector<uint32_t> order_;  // позиция на экране -> строка данных
+    size_t rowCount_ = 0;
+
+    int sortColumn_ = -1;
+    bool sortAscending_ = true;
+
+    size_t cursor_ = 0;            // выбранная позиция (в порядке order_)
+    size_t scrollOffset_ = 0;
+    int currentColumn_ = 0;
+    int leftColumn_ = 0;           // первая видимая колонка
+    bool hasFocus_ = false;
+    std::function<void(int)> onSelect_;
+
+    // Буферы сортировки сохраняются между вызовами
+    std::vector<SortKey> sortKeys_;
+    std::vector<SortKey> sortBuffer_;
+
+    // Отображение числа в uint64 с сохранением порядка
+    static uint64_t intKey(int64_t v) {
+        return static_cast<uint64_t>(v) ^ (uint64_t(1) << 63);
+    }
+
+    static uint64_t doubleKey(double v) {
+        if (v == 0.0) v = 0.0;  // -0.0 и 0.0 равны
+        uint64_t bits;
+        std::memcpy(&bits, &v, sizeof(bits));
+        return (bits & (uint64_t(1) << 63)) ? ~bits : bits ^ (uint64_t(1) << 63);
+    }
+
+    // 8 байт строки начиная с offset (big-endian), короткие дополняются нулями
+    static uint64_t textKey(const std::string& s, size_t offset = 0) {
+        uint64_t key = 0;
+        size_t n = s.size() > offset ? std::min<size_t>(8, s.size() - offset) : 0;
+        for (size_t i = 0; i < n; i++) {
+            key |= static_cast<uint64_t>(static_cast<unsigned char>(s[offset + i])) << (56 - 8 * i);
+        }
+        return key;
+    }
+
+    uint64_t sortKey(const Column& col, size_t row) const {
+        switch (col.type) {
+            case ColumnType::Int: return intKey(col.ints[row]);
+            case ColumnType::Double: return doubleKey(col.reals[row]);
+            default: return textKey(col.texts[row]);
+        }
+    }
+
+    /**
+     * @brief Устойчивая поразрядная (LSD) сортировка ключей
+     *
+     * Каждый проход по байту ключа: подсчёт гистограмм по частям
+     * и раскладка частей выполняются параллельно на пуле. Проходы,
+     * где все ключи имеют одинаковый байт, пропускаются.
+     */
+    static void radixSort(SortKey* data, size_t n, std::vector<SortKey>& buffer) {
+        if (n < 2) return;
+        ThreadPool& pool = ThreadPool::shared();
+        if (buffer.size() < n) buffer.resize(n);
+        SortKey* src = data;
+        SortKey* dst = buffer.data();
+
+        // Гистограммы всех байтов за один проход - по ним видно пропускаемые проходы
+        using Histogram = std::array<std::array<size_t, 256>, 8>;
+        std::vector<Histogram> counts(pool.size() + 1);
+        for (auto& h : counts) for (auto& c : h) c.fill(0);
+        size_t chunks = pool.parallelFor(0, n, kSortChunk, [&](size_t b, size_t e, size_t chunk) {
+            Histogram& h = counts[chunk];
+            for (size_t i = b; i < e; i++) {
+                uint64_t key = src[i].key;
+                for (int byte = 0; byte < 8; byte++) h[byte][(key >> (8 * byte)) & 0xFF]++;
+            }
+        });
+
+        bool moved = false;
+        for (int byte = 0; byte < 8; byte++) {
+            int shift = 8 * byte;
+            bool uniform = false;
+            for (size_t d = 0; d < 256 && !uniform; d++) {
+                size_t total = 0;
+                for (size_t c = 0; c < chunks; c++) total += counts[c][byte][d];
+                uniform = total == n;
+            }
+            if (uniform) continue;
+
+            // После раскладки части содержат другие ключи - пересчёт
+            if (chunks > 1 && moved) {
+                pool.parallelFor(0, n, kSortChunk, [&](size_t b, size_t e, size_t chunk) {
+                    std::array<size_t, 256>& c = counts[chunk][byte];
+                    c.fill(0);
+                    for (size_t i = b; i < e; i++) c[(src[i].key >> shift) & 0xFF]++;
+                });
+            }
+
+            // Смещения: байт по возрастанию, внутри байта - части по порядку
+            size_t total = 0;
+            for (size_t d = 0; d < 256; d++) {
+                for (size_t c = 0; c < chunks; c++) {
+                    size_t count = counts[c][byte][d];
+                    counts[c][byte][d] = total;
+                    total += count;
+                }
+            }
+
+            pool.parallelFor(0, n, kSortChunk, [&](size_t b, size_t e, size_t chunk) {
+                std::array<size_t, 256>& offset = counts[chunk][byte];
+                for (size_t i = b; i < e; i++) {
+                    dst[offset[(src[i].key >> shift) & 0xFF]++] = src[i];
+                }
+            });
+            std::swap(src, dst);
+            moved = true;
+        }
+
+        if (src != data) std::copy(src, src + n, data);
+    }
+
+    /**
+     * @brief Досортировать группы с равным 8-байтным префиксом строки
+     *
+     * Большие группы сортируются по следующим 8 байтам тем же
+     * поразрядным способом, маленькие - сравнением строк.
+     */
+    static void sortTextRuns(const std::vector<std::string>& texts, SortKey* data, size_t n,
+                             size_t depth, bool ascending, std::vector<SortKey>& buffer) {
+        size_t runStart = 0;
+        for (size_t i = 1; i <= n; i++) {
+            if (i < n && data[i].key == data[runStart].key) continue;
+            size_t len = i - runStart;
+            SortKey* run = data + runStart;
+            runStart = i;
+            if (len < 2) continue;
+
+            bool longer = false;
+            for (size_t k = 0; k < len && !longer; k++) {
+                longer = texts[run[k].row].size() > depth + 8;
+            }
+            if (!longer) continue;
+
+            if (len < kRadixMin) {
+                // Вход упорядочен по номеру строки - stable_sort сохраняет это для равных
+                std::stable_sort(run, run + len, [&texts, ascending](const SortKey& a, const SortKey& b) {
+                    int cmp = texts[a.row].compare(texts[b.row]);
+                    return ascending ? cmp < 0 : cmp > 0;
+                });
+                continue;
+            }
+            for (size_t k = 0; k < len; k++) {
+                uint64_t key = textKey(texts[run[k].row], depth + 8);
+                run[k].key = ascending ? key : ~key;
+            }
+            radixSort(run, len, buffer);
+            sortTextRuns(texts, run, len, depth + 8, ascending, buffer);
+        }
+    }
+
+    void markColumnsDirty() {
+        for (auto& col : columns_) col.widthDirty = true;
+    }
+
+    // Ширина колонки; автоширина пересчитывается по выборке строк
+    int columnWidth(int c) {
+        Column& col = columns_[c];
+        if (col.fixedWidth > 0) return col.fixedWidth;
+        if (col.widthDirty) {
+            int w = static_cast<int>(col.title.length()) + 1;  // место под стрелку сортировки
+            size_t step = std::max<size_t>(1, rowCount_ / kWidthSample);
+            for (size_t row = 0; row < rowCount_; row += step) {
+                w = std::max(w, static_cast<int>(getCellText(static_cast<int>(row), c).length()));
+            }
+            col.autoWidth = std::min(std::max(w, 1), kMaxAutoWidth);
+            col.widthDirty = false;
+        }
+        return col.autoWidth;
+    }
+
+    Column* cell(int row, int col) {
+        if (col < 0 || col >= static_cast<int>(columns_.size())) return nullptr;
+        if (row < 0 || static_cast<size_t>(row) >= rowCount_) return nullptr;
+        return &columns_[col];
+    }
+
+    const Column* cell(int row, int col) const {
+        return const_cast<DataGrid*>(this)->cell(row, col);
+    }
+
+    void ensureCursorVisible() {
+        size_t visible = static_cast<size_t>(std::max(1, getVisibleCount()));
+        if (cursor_ < scrollOffset_) {
+            scrollOffset_ = cursor_;
+        } else if (cursor_ >= scrollOffset_ + visible) {
+            scrollOffset_ = cursor_ - visible + 1;
+        }
+    }
+
+    void moveCursor(long long pos) {
+        if (rowCount_ == 0) return;
+        pos = std::max(0LL, std::min(pos, static_cast<long long>(rowCount_) - 1));
+        cursor_ = static_cast<size_t>(pos);
+        ensureCursorVisible();
+    }
+
+    // Прокрутка по горизонтали до текущей колонки
+    void ensureColumnVisible() {
+        if (currentColumn_ < leftColumn_) {
+            leftColumn_ = currentColumn_;
+            return;
+        }
+        int inner = width_ - 2;
+        while (leftColumn_ < currentColumn_) {
+            int used = 0;
+            for (int c = leftColumn_; c <= currentColumn_; c++) {
+                used += columnWidth(c) + 1;
+            }
+            if (used - 1 <= inner) break;
+            leftColumn_++;
+        }
+    }
+
+    static std::string fit(std::string text, int width, bool alignRight) {
+        if (static_cast<int>(text.length()) > width) {
+            text.resize(width);
+        } else if (alignRight) {
+            text.insert(0, width - text.length(), ' ');
+        } else {
+            text.append(width - text.length(), ' ');
+        }
+        return text;
+    }
+
+public:
+    DataGrid(int x, int y, int width, int height)
+        : Widget(x, y, width, height) {
+        canFocus_ = true;
+    }
+
+    // ---- Колонки ----
+
+    int addColumn(const std::string& title, ColumnType type = ColumnType::Text, int width = 0) {
+        Column col;
+        col.title = title;
+        col.type = type;
+        col.fixedWidth = width;
+        switch (type) {
+            case ColumnType::Int: col.ints.resize(rowCount_); break;
+            case ColumnType::Double: col.reals.resize(rowCount_); break;
+            case ColumnType::Text: col.texts.resize(rowCount_); break;
+        }
+        columns_.push_back(std::move(col));
+        return static_cast<int>(columns_.size()) - 1;
+    }
+
+    int getColumnCount() const { return static_cast<int>(columns_.size()); }
+    ColumnType getColumnType(int col) const { return columns_[col].type; }
+
+    void setColumnWidth(int col, int width) {
+        columns_[col].fixedWidth = width;
+    }
+
+    void setColumnPrecision(int col, int precision) {
+        columns_[col].precision = precision;
+        columns_[col].widthDirty = true;
+    }
+
+    // ---- Строки ----
+
+    int getRowCount() const { return static_cast<int>(rowCount_); }
+
+    void reserveRows(size_t rows) {
+        order_.reserve(rows);
+        for (auto& col : columns_) {
+            switch (col.type) {
+                case ColumnType::Int: col.ints.reserve(rows); break;
+                case ColumnType::Double: col.reals.reserve(rows); break;
+                case ColumnType::Text: col.texts.reserve(rows); break;
+            }
+        }
+    }
+
+    /**
+     * @brief Изменить число строк (для пакетной загрузки)
+     *
+     * Новые строки заполнены нулями и пустыми строками. Сортировка
+     * сбрасывается: строки возвращаются в исходный порядок, курсор
+     * остаётся на той же строке данных, если она не удалена.
+     */
+    void setRowCount(size_t rows) {
+        int selectedRow = getSelectedRow();
+        for (auto& col : columns_) {
+            switch (col.type) {
+                case ColumnType::Int: col.ints.resize(rows); break;
+                case ColumnType::Double: col.reals.resize(rows); break;
+                case ColumnType::Text: col.texts.resize(rows); break;
+            }
+        }
+        // Без сортировки order_ тождественный: достаточно дописать хвост
+        bool sorted = sortColumn_ >= 0;
+        size_t keep = sorted ? 0 : std::min(rowCount_, rows);
+        order_.resize(rows);
+        for (size_t r = keep; r < rows; r++) order_[r] = static_cast<uint32_t>(r);
+        rowCount_ = rows;
+        sortColumn_ = -1;
+        markColumnsDirty();
+        if (sorted && selectedRow >= 0 && static_cast<size_t>(selectedRow) < rows) {
+            setSelectedRow(selectedRow);
+        } else {
+            moveCursor(static_cast<long long>(cursor_));
+        }
+    }
+
+    int addRow() {
+        setRowCount(rowCount_ + 1);
+        return static_cast<int>(rowCount_) - 1;
+    }
+
+    void clearRows() {
+        setRowCount(0);
+        order_.clear();
+        sortKeys_ = std::vector<SortKey>();
+        sortBuffer_ = std::vector<SortKey>();
+        cursor_ = 0;
+        scrollOffset_ = 0;
+    }
+
+    // ---- Ячейки ----
+
+    void setInt(int row, int col, int64_t value) {
+        Column* c = cell(row, col);
+        if (!c || c->type != ColumnType::Int) return;
+        c->ints[row] = value;
+        c->widthDirty = true;
+    }
+
+    void setDouble(int row, int col, double value) {
+        Column* c = cell(row, col);
+        if (!c || c->type != ColumnType::Double) return;
+        c->reals[row] = value;
+        c->widthDirty = true;
+    }
+
+    void setText(int row, int col, const std::string& value) {
+        Column* c = cell(row, col);
+        if (!c || c->type != ColumnType::Text) return;
+        c->texts[row] = value;
+        c->widthDirty = true;
+    }
+
+    int64_t getInt(int row, int col) const {
+        const Column* c = cell(row, col);
+        return (c && c->type == ColumnType::Int) ? c->ints[row] : 0;
+    }
+
+    double getDouble(int row, int col) const {
+        const Column* c = cell(row, col);
+        return (c && c->type == ColumnType::Double) ? c->reals[row] : 0.0;
+    }
+
+    std::string getText(int row, int col) const {
+        const Column* c = cell(row, col);
+        return (c && c->type == ColumnType::Text) ? c->texts[row] : std::string();
+    }
+
+    // Текст ячейки в том виде, в каком она отображается
+    std::string getCellText(int row, int col) const {
+        const Column* c = cell(row, col);
+        if (!c) return std::string();
+        switch (c->type) {
+            case ColumnType::Int:
+                return std::to_string(c->ints[row]);
+            case ColumnType::Double: {
+                char buf[64];
+                snprintf(buf, sizeof(buf), "%.*f", c->precision, c->reals[row]);
+                return buf;
+            }
+            default:
+                return c->texts[row];
+        }
+    }
+
+    // ---- Сортировка ----
+
+    /**
+     * @brief Отсортировать строки по колонке (устойчиво)
+     *
+     * Сортируются пары "8-байтный ключ + номер строки": для чисел
+     * ключ точный, для текста - префикс, группы с равным префиксом
+     * досортировываются по следующим байтам.
+     */
+    void sortBy(int col, bool ascending = true) {
+        if (col < 0 || col >= static_cast<int>(columns_.size())) return;
+        const Column& column = columns_[col];
+        int selectedRow = getSelectedRow();
+
+        std::vector<SortKey>& keys = sortKeys_;
+        keys.resize(rowCount_);
+        ThreadPool::shared().parallelFor(0, rowCount_, kSortChunk, [&](size_t b, size_t e, size_t) {
+            for (size_t r = b; r < e; r++) {
+                uint64_t key = sortKey(column, r);
+                keys[r] = {ascending ? key : ~key, static_cast<uint32_t>(r)};
+            }
+        });
+
+        radixSort(keys.data(), keys.size(), sortBuffer_);
+        if (column.type == ColumnType::Text) {
+            sortTextRuns(column.texts, keys.data(), keys.size(), 0, ascending, sortBuffer_);
+        }
+
+        for (size_t i = 0; i < rowCount_; i++) order_[i] = keys[i].row;
+        sortColumn_ = col;
+        sortAscending_ = ascending;
+
+        // Курсор остаётся на той же строке данных
+        if (selectedRow >= 0) setSelectedRow(selectedRow);
+    }
+
+    // Вернуть исходный порядок строк
+    void clearSort() {
+        int selectedRow = getSelectedRow();
+        for (size_t i = 0; i < rowCount_; i++) order_[i] = static_cast<uint32_t>(i);
+        sortColumn_ = -1;
+        if (selectedRow >= 0) setSelectedRow(selectedRow);
+    }
+
+    int getSortColumn() const { return sortColumn_; }
+    bool isSortAscending() const { return sortAscending_; }
+
+    // ---- Выбор и прокрутка ----
+
+    // Строка данных на позиции экрана (с учётом сортировки)
+    int getDisplayRow(int pos) const {
+        if (pos < 0 || static_cast<size_t>(pos) >= rowCount_) return -1;
+        return static_cast<int>(order_[pos]);
+    }
+
+    int getSelectedRow() const { return getDisplayRow(static_cast<int>(cursor_)); }
+
+    void setSelectedRow(int row) {
+        if (row < 0 || static_cast<size_t>(row) >= rowCount_) return;
+        auto it = std::find(order_.begin(), order_.end(), static_cast<uint32_t>(row));
+        moveCursor(it - order_.begin());
+    }
+
+    int getCurrentColumn() const { return currentColumn_; }
+
+    void setCurrentColumn(int col) {
+        if (col < 0 || col >= static_cast<int>(columns_.size())) return;
+        currentColumn_ = col;
+        ensureColumnVisible();
+    }
+
+    // Видимых строк данных (без рамки и заголовка)
+    int getVisibleCount() const { return std::max(0, height_ - 3); }
+
+    int getScrollOffset() const { return static_cast<int>(scrollOffset_); }
+
+    void setOnSelect(std::function<void(int)> callback) {
+        onSelect_ = callback;
+    }
+
+    bool hasFocus() const { return hasFocus_; }
+
+    void setFocused(bool focus) override {
+        focused_ = focus;
+        hasFocus_ = focus;
+    }
+
+    bool handleKey(Key key) override {
+        if (!visible_ || !enabled_ || !hasFocus_) return false;
+
+        long long page = std::max(1, getVisibleCount());
+        long long pos = static_cast<long long>(cursor_);
+
+        switch (key) {
+            case Key::Up:
+                moveCursor(pos - 1);
+                return true;
+
+            case Key::Down:
+                moveCursor(pos + 1);
+                return true;
+
+            case Key::PageUp:
+                moveCursor(pos - page);
+                return true;
+
+            case Key::PageDown:
+                moveCursor(pos + page);
+                return true;
+
+            case Key::Home:
+                moveCursor(0);
+                return true;
+
+            case Key::End:
+                moveCursor(static_cast<long long>(rowCount_) - 1);
+                return true;
+
+            case Key::Left:
+                setCurrentColumn(currentColumn_ - 1);
+                return true;
+
+            case Key::Right:
+                setCurrentColumn(currentColumn_ + 1);
+                return true;
+
+            case Key::Space:
+                // Сортировка по текущей колонке, повтор меняет направление
+                if (currentColumn_ < static_cast<int>(columns_.size())) {
+                    bool ascending = !(sortColumn_ == currentColumn_ && sortAscending_);
+                    sortBy(currentColumn_, ascending);
+                }
+                return true;
+
+            case Key::Enter:
+                if (onSelect_ && getSelectedRow() >= 0) onSelect_(getSelectedRow());
+                return true;
+
+            default:
+                return false;
+        }
+    }
+
+    void draw(Screen& screen) override {
+        if (!visible_) return;
+
+        ThemeRole normalColor = enabled_ ? ThemeRole::ListBoxNormal : ThemeRole::ListBoxDisabled;
+        ThemeRole focusColor = enabled_ ? ThemeRole::ListBoxFocused : ThemeRole::ListBoxDisabled;
+        ThemeRole headerColor = enabled_ ? ThemeRole::ListBoxText : ThemeRole::ListBoxDisabled;
+
+        screen.drawBox(x_, y_, width_, height_, BoxStyles::thin(), hasFocus_ ? focusColor : normalColor);
+
+        int inner = width_ - 2;
+        int visibleRows = getVisibleCount();
+        if (inner <= 0) return;
+
+        // Колонки, попадающие в окно
+        struct Slot { int col; int x; int w; };
+        std::vector<Slot> slots;
+        int cx = 0;
+        for (int c = leftColumn_; c < static_cast<int>(columns_.size()) && cx < inner; c++) {
+            int w = std::min(columnWidth(c), inner - cx);
+            slots.push_back({c, cx, w});
+            cx += w + 1;
+        }
+
+        // Закреплённый заголовок
+        std::string header(inner, ' ');
+        for (const Slot& s : slots) {
+            std::string title = columns_[s.col].title;
+            if (s.col == sortColumn_) {
+                title += sortAscending_ ? Symbols::arrowUp : Symbols::arrowDown;
+            }
+            header.replace(s.x, s.w, fit(title, s.w, false));
+            if (s.x + s.w < inner) header.replace(s.x + s.w, 1, Symbols::separatorV);
+        }
+        screen.putString(x_ + 1, y_ + 1, header, headerColor);
+        for (const Slot& s : slots) {
+            if (s.col == currentColumn_ && hasFocus_) {
+                screen.putString(x_ + 1 + s.x, y_ + 1, header.substr(s.x, s.w), ThemeRole::ListBoxHighlight);
+            }
+        }
+
+        // Только видимые строки
+        for (int i = 0; i < visibleRows; i++) {
+            size_t pos = scrollOffset_ + i;
+            std::string line(inner, ' ');
+            if (pos < rowCount_) {
+                int row = static_cast<int>(order_[pos]);
+                for (const Slot& s : slots) {
+                    bool right = columns_[s.col].type != ColumnType::Text;
+                    line.replace(s.x, s.w, fit(getCellText(row, s.col), s.w, right));
+                    if (s.x + s.w < inner) line.replace(s.x + s.w, 1, Symbols::separatorV);
+                }
+            }
+            bool selected = pos == cursor_ && pos < rowCount_ && hasFocus_;
+            screen.putString(x_ + 1, y_ + 2 + i, line, selected ? focusColor : normalColor);
+        }
+
+        // Позиция в нижней рамке
+        if (rowCount_ > 0 && width_ > 6) {
+            std::string status = " " + std::to_string(cursor_ + 1) + "/" + std::to_string(rowCount_) + " ";
+            if (static_cast<int>(status.length()) <= width_ - 4) {
+                screen.putString(x_ + width_ - 2 - static_cast<int>(status.length()), y_ + height_ - 1,
+                                 status, hasFocus_ ? focusColor : normalColor);
+            }
+        }
+
+        // Индикатор фокуса
+        if (hasFocus_) {
+            screen.putString(x_ - 1, y_, "#", TextStyle::biosMenu());
+        }
+    }
+};
+
+} // namespace ui
+
+#endif // TEXTUI_DATAGRID_H
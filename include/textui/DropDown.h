@@ -2,10 +2,12 @@
 #define TEXTUI_DROPDOWN_H
 
 #include "Widget.h"
+#include "ItemFilter.h"
 #include "../core/Screen.h"
 #include <vector>
 #include <string>
 #include <functional>
+#include <algorithm>
 
 namespace ui {
 
@@ -20,6 +22,49 @@ private:
     bool hasFocus_ = false;
     int maxVisibleItems_ = 5;
     std::function<void(int)> onSelect_;
+    ItemFilter filter_;            // РїРѕСЃР»Рµ items_: Р·Р°РґР°РЅРёРµ С‡РёС‚Р°РµС‚ СЃРїРёСЃРѕРє
+    bool typeToFilter_ = false;
+    int scrollOffset_ = 0;         // РїРµСЂРІР°СЏ РІРёРґРёРјР°СЏ СЃС‚СЂРѕРєР° СЂР°СЃРєСЂС‹С‚РѕРіРѕ СЃРїРёСЃРєР°
+
+    // РџСЂРѕРєСЂСѓС‚РєР° СЂР°СЃРєСЂС‹С‚РѕРіРѕ СЃРїРёСЃРєР° Рє РІС‹Р±СЂР°РЅРЅРѕРјСѓ СЌР»РµРјРµРЅС‚Сѓ
+    void ensureSelectedVisible() {
+        int row = filter_.itemToRow(selectedIndex_);
+        if (row < 0) return;
+        if (row < scrollOffset_) {
+            scrollOffset_ = row;
+        } else if (row >= scrollOffset_ + maxVisibleItems_) {
+            scrollOffset_ = row - maxVisibleItems_ + 1;
+        }
+    }
+
+    // Р’С‹Р±РѕСЂ РІРёРґРёРјРѕР№ СЃС‚СЂРѕРєРё СЂР°СЃРєСЂС‹С‚РѕРіРѕ СЃРїРёСЃРєР°
+    void moveToRow(int row) {
+        int rows = getRowCount();
+        if (rows == 0) return;
+        row = std::max(0, std::min(row, rows - 1));
+        selectedIndex_ = filter_.rowToItem(row);
+        ensureSelectedVisible();
+    }
+
+    // РЎРѕРіР»Р°СЃРѕРІР°С‚СЊ РІС‹Р±РѕСЂ Рё РїСЂРѕРєСЂСѓС‚РєСѓ СЃ РЅРѕРІС‹Рј РЅР°Р±РѕСЂРѕРј СЃС‚СЂРѕРє
+    void syncWithFilter() {
+        int rows = getRowCount();
+        if (rows > 0 && filter_.itemToRow(selectedIndex_) < 0) {
+            selectedIndex_ = filter_.rowToItem(0);
+        }
+        int maxOffset = std::max(0, rows - maxVisibleItems_);
+        if (scrollOffset_ > maxOffset) scrollOffset_ = maxOffset;
+        ensureSelectedVisible();
+    }
+
+    // РЎРІРµСЂРЅСѓС‚СЊ СЃРїРёСЃРѕРє; Р·Р°РїСЂРѕСЃ С„РёР»СЊС‚СЂР° СЃР±СЂР°СЃС‹РІР°РµС‚СЃСЏ
+    void collapse() {
+        expanded_ = false;
+        if (filter_.active()) {
+            filter_.setQuery(items_, "");
+            syncWithFilter();
+        }
+    }
 
 public:
     DropDown(int x, int y, int width)
@@ -27,21 +72,44 @@ public:
         canFocus_ = true;
     }
 
+    /**
+     * @brief Р—Р°Р±СЂР°С‚СЊ СЂРµР·СѓР»СЊС‚Р°С‚ С„РѕРЅРѕРІРѕР№ С„РёР»СЊС‚СЂР°С†РёРё
+     * Р’С‹Р·С‹РІР°РµС‚СЃСЏ РёР· draw/handleKey; App, РєСЂРѕРјРµ С‚РѕРіРѕ, Р·Р°Р±РёСЂР°РµС‚ РµРіРѕ РІ
+     * РєР°РґСЂРµ, РєРѕС‚РѕСЂС‹Р№ Р±СѓРґРёС‚ setOnFilterReady, - Р±РµР· РЅР°Р¶Р°С‚РёСЏ РєР»Р°РІРёС€Рё.
+     * @return true - РЅР°Р±РѕСЂ РІРёРґРёРјС‹С… СЃС‚СЂРѕРє РёР·РјРµРЅРёР»СЃСЏ
+     */
+    bool pollFilter() {
+        if (!filter_.poll(items_)) return false;
+        syncWithFilter();
+        return true;
+    }
+
+    // Р¤РѕРЅРѕРІР°СЏ С„РёР»СЊС‚СЂР°С†РёСЏ Р·Р°РєРѕРЅС‡РёР»Р°СЃСЊ (РІС‹Р·С‹РІР°РµС‚СЃСЏ РёР· РµС‘ РїРѕС‚РѕРєР°), СЃРј. ItemFilter::setOnReady
+    void setOnFilterReady(std::function<void()> onReady) { filter_.setOnReady(std::move(onReady)); }
+
     void setMaxVisibleItems(int count) {
         maxVisibleItems_ = count;
     }
 
     // Р”РѕР±Р°РІР»РµРЅРёРµ СЌР»РµРјРµРЅС‚Р°
     void addItem(const std::string& item) {
+        filter_.prepareAppend(items_);
         items_.push_back(item);
+        filter_.itemAppended(items_);
         if (selectedIndex_ < 0) selectedIndex_ = 0;
+        if (filter_.active()) syncWithFilter();
     }
 
     void clearItems() {
+        filter_.cancel();
         items_.clear();
         selectedIndex_ = -1;
+        scrollOffset_ = 0;
+        filter_.refresh(items_);
     }
 
+    int getCount() const { return static_cast<int>(items_.size()); }
+
     int getSelectedIndex() const { return selectedIndex_; }
 
     void setSelectedIndex(int index) {
@@ -62,42 +130,94 @@ public:
         onSelect_ = callback;
     }
 
+    // Р¤РёР»СЊС‚СЂ СЂР°СЃРєСЂС‹С‚РѕРіРѕ СЃРїРёСЃРєР° РїРѕ РїРѕРґСЃС‚СЂРѕРєРµ (Р±РµР· СѓС‡С‘С‚Р° СЂРµРіРёСЃС‚СЂР°)
+    void setFilter(const std::string& query) {
+        filter_.setQuery(items_, query);
+        syncWithFilter();
+    }
+
+    const std::string& getFilter() const { return filter_.query(); }
+    void clearFilter() { setFilter(""); }
+    bool isFilterPending() const { return filter_.pending(); }
+
+    // Р РµР¶РёРј "РЅР°Р±РµСЂРё РґР»СЏ РїРѕРёСЃРєР°" РІ СЂР°СЃРєСЂС‹С‚РѕРј СЃРїРёСЃРєРµ
+    void setTypeToFilter(bool enable) { typeToFilter_ = enable; }
+    bool isTypeToFilter() const { return typeToFilter_; }
+
+    bool wantsTextInput() const override { return typeToFilter_ && expanded_; }
+
+    // Р Р°СЃРєСЂС‹С‚С‹Р№ СЃРїРёСЃРѕРє РјРѕР¶РµС‚ РІС‹С…РѕРґРёС‚СЊ Р·Р° РѕРєРЅРѕ
+    bool canDrawConcurrently() const override { return !expanded_; }
+
+    // Р§РёСЃР»Рѕ РІРёРґРёРјС‹С… (РїСЂРѕС€РµРґС€РёС… С„РёР»СЊС‚СЂ) СЃС‚СЂРѕРє
+    int getRowCount() const { return filter_.rowCount(static_cast<int>(items_.size())); }
+
+    bool isExpanded() const { return expanded_; }
+
     bool hasFocus() const { return hasFocus_; }
 
     void setFocused(bool focus) override {
         focused_ = focus;
         hasFocus_ = focus;
         if (!focus) {
-            expanded_ = false;
+            collapse();
         }
     }
 
     bool handleKey(Key key) override {
         if (!visible_ || !enabled_ || !hasFocus_) return false;
+        pollFilter();
 
         if (expanded_) {
+            // Р’РІРѕРґ Р·Р°РїСЂРѕСЃР° С„РёР»СЊС‚СЂР°
+            if (typeToFilter_) {
+                if (key == Key::Backspace) {
+                    if (filter_.active()) {
+                        std::string query = filter_.query();
+                        query.pop_back();
+                        setFilter(query);
+                    }
+                    return true;
+                }
+                if (key == Key::Escape && filter_.active()) {
+                    clearFilter();
+                    return true;
+                }
+                if (key >= Key::Space && key < Key::Up) {
+                    setFilter(filter_.query() + static_cast<char>(static_cast<int>(key)));
+                    return true;
+                }
+            }
+
+            int row = filter_.itemToRow(selectedIndex_);
             // РќР°РІРёРіР°С†РёСЏ РІ СЂР°СЃРєСЂС‹С‚РѕРј СЃРїРёСЃРєРµ
             switch (key) {
                 case Key::Up:
-                    if (selectedIndex_ > 0) {
-                        selectedIndex_--;
-                    }
+                    moveToRow(row < 0 ? 0 : row - 1);
                     return true;
 
                 case Key::Down:
-                    if (selectedIndex_ < static_cast<int>(items_.size()) - 1) {
-                        selectedIndex_++;
-                    }
+                    moveToRow(row + 1);
+                    return true;
+
+                case Key::Home:
+                    moveToRow(0);
+                    return true;
+
+                case Key::End:
+                    moveToRow(getRowCount() - 1);
                     return true;
 
                 case Key::Enter:
-                case Key::Space:
-                    expanded_ = false;
-                    if (onSelect_) onSelect_(selectedIndex_);
+                case Key::Space: {
+                    bool picked = row >= 0;
+                    collapse();
+                    if (picked && onSelect_) onSelect_(selectedIndex_);
                     return true;
+                }
 
                 case Key::Escape:
-                    expanded_ = false;
+                    collapse();
                     return true;
 
                 default:
@@ -110,6 +230,7 @@ public:
                 case Key::Space:
                     if (!items_.empty()) {
                         expanded_ = true;
+                        ensureSelectedVisible();
                     }
                     return true;
 
@@ -139,6 +260,7 @@ public:
             setFocus(true);
             if (!expanded_ && !items_.empty()) {
                 expanded_ = true;
+                ensureSelectedVisible();
             }
             return true;
         }
@@ -147,10 +269,11 @@ public:
 
     void draw(Screen& screen) override {
         if (!visible_) return;
+        pollFilter();
 
-        ColorAttr normalColor = enabled_ ? ColorAttr::normal() : ColorAttr::biosDisabled();
-        ColorAttr focusColor = enabled_ ? ColorAttr::highlight() : ColorAttr::biosDisabled();
-        ColorAttr color = hasFocus_ ? focusColor : normalColor;
+        ThemeRole normalColor = enabled_ ? ThemeRole::ListBoxNormal : ThemeRole::ListBoxDisabled;
+        ThemeRole focusColor = enabled_ ? ThemeRole::ListBoxFocused : ThemeRole::ListBoxDisabled;
+        ThemeRole color = hasFocus_ ? focusColor : normalColor;
 
         // Р Р°РјРєР° РєРѕРЅС‚СЂРѕР»Р°
         screen.drawBox(x_, y_, width_, 3, BoxStyles::thin(), color);
@@ -180,30 +303,46 @@ public:
             std::string hotkeyText = "[";
             hotkeyText += static_cast<char>(toupper(hotkey_));
             hotkeyText += "]";
-            screen.putString(x_, y_, hotkeyText.c_str(), TextStyle::biosHotkey());
+            screen.putString(x_, y_, hotkeyText.c_str(), ThemeRole::Hotkey);
         }
 
         // Р Р°СЃРєСЂС‹С‚С‹Р№ СЃРїРёСЃРѕРє
         if (expanded_) {
-            int visibleItems = std::min(static_cast<int>(items_.size()), maxVisibleItems_);
+            int rows = getRowCount();
+            int visibleItems = std::min(std::max(rows, 1), maxVisibleItems_);
             int listHeight = visibleItems + 2;
             int listY = y_ + 2;
+            int lineWidth = width_ - 2;
 
             // Р Р°РјРєР° СЃРїРёСЃРєР°
             screen.drawBox(x_, listY, width_, listHeight, BoxStyles::thin(), color);
 
-            // Р­Р»РµРјРµРЅС‚С‹
+            // Р­Р»РµРјРµРЅС‚С‹ (СЃС‚СЂРѕРєРё, РїСЂРѕС€РµРґС€РёРµ С„РёР»СЊС‚СЂ)
             for (int i = 0; i < visibleItems; i++) {
-                bool isSelected = (i == selectedIndex_);
-                ColorAttr itemColor = isSelected ? focusColor : normalColor;
-                
-                std::string itemText = " " + items_[i];
-                if (isSelected) {
-                    itemText = Symbols::arrowRight + items_[i];
+                int item = filter_.rowToItem(scrollOffset_ + i);
+                std::string itemText;
+                bool isSelected = false;
+                if (item >= 0) {
+                    isSelected = (item == selectedIndex_);
+                    itemText = (isSelected ? Symbols::arrowRight : " ") + items_[item];
+                }
+                if (static_cast<int>(itemText.length()) > lineWidth) {
+                    itemText.resize(lineWidth);
+                } else {
+                    itemText.append(lineWidth - itemText.length(), ' ');
                 }
-                
+                ThemeRole itemColor = isSelected ? focusColor : normalColor;
                 screen.putString(x_ + 1, listY + 1 + i, itemText.c_str(), itemColor);
             }
+
+            // Р—Р°РїСЂРѕСЃ С„РёР»СЊС‚СЂР° РІ РЅРёР¶РЅРµР№ СЂР°РјРєРµ СЃРїРёСЃРєР°
+            if (filter_.active() && width_ > 4) {
+                std::string query = "/" + filter_.query() + (filter_.pending() ? "..." : "");
+                if (static_cast<int>(query.length()) > width_ - 4) {
+                    query = query.substr(query.length() - (width_ - 4));
+                }
+                screen.putString(x_ + 2, listY + listHeight - 1, query, color);
+            }
         }
     }
 };
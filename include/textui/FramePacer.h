@@ -0,0 +1,130 @@
+#ifndef TEXTUI_FRAMEPACER_H
+#define TEXTUI_FRAMEPACER_H
+
+#include "TerminalWriter.h"
+#include <chrono>
+#include <cstdint>
+
+namespace ui {
+
+/**
+ * @brief Подстройка частоты кадров под пропускную способность терминала
+ *
+ * По счётчикам вывода (байты, время в write) и очереди терминала
+ * (TIOCOUTQ) оценивает скорость линии. Пока линия не ограничивает,
+ * кадры идут с полной частотой; на медленной линии интервал между
+ * кадрами растёт до времени передачи среднего кадра, а разница
+ * собирается крупнее (FrameEncoder::setGapLimit).
+ */
+class FramePacer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr int kMinFrameMs = 16;              // полная частота (~60 кадров/с)
+    static constexpr int kMaxFrameMs = 2000;
+    static constexpr double kSlowLinkBytesPerSec = 64 * 1024;
+    static constexpr int kSlowGapLimit = 8;             // не длиннее CSI y;x H
+    static constexpr double kBlockedWriteSeconds = 0.002;
+    static constexpr int kFreeSamplesToReset = 30;      // образцов без затора до сброса оценки
+    static constexpr double kSmoothing = 0.25;
+
+    struct Decision {
+        int minFrameMs = kMinFrameMs;   // не чаще одного кадра за столько мс
+        int gapLimit = 0;               // гранулярность разницы
+        double bytesPerSec = 0;         // оценка скорости линии (0 - не ограничивает)
+        double frameBytes = 0;          // средний размер кадра
+        bool limited = false;           // частота снижена из-за линии
+    };
+
+private:
+    Decision decision_;
+    TerminalWriter::Stats last_;
+    int lastQueued_ = 0;
+    Clock::time_point lastTime_;
+    bool hasLast_ = false;
+    int freeSamples_ = 0;
+
+    static double smooth(double current, double sample) {
+        return current <= 0 ? sample : current + (sample - current) * kSmoothing;
+    }
+
+    void decide() {
+        if (decision_.bytesPerSec <= 0) {
+            decision_.minFrameMs = kMinFrameMs;
+            decision_.gapLimit = 0;
+            decision_.limited = false;
+            return;
+        }
+        double transmitMs = decision_.frameBytes / decision_.bytesPerSec * 1000.0;
+        int frameMs = static_cast<int>(transmitMs + 0.5);
+        if (frameMs < kMinFrameMs) frameMs = kMinFrameMs;
+        if (frameMs > kMaxFrameMs) frameMs = kMaxFrameMs;
+        decision_.minFrameMs = frameMs;
+        decision_.limited = frameMs > kMinFrameMs;
+        decision_.gapLimit = decision_.bytesPerSec < kSlowLinkBytesPerSec ? kSlowGapLimit : 0;
+    }
+
+public:
+    /**
+     * @brief Учесть счётчики вывода (раз в кадр)
+     * @param totals накопленные счётчики Screen::getOutputStats()
+     * @param queued байт в очереди терминала сейчас
+     */
+    void sample(const TerminalWriter::Stats& totals, int queued, Clock::time_point now = Clock::now()) {
+        if (!hasLast_) {
+            last_ = totals;
+            lastQueued_ = queued;
+            lastTime_ = now;
+            hasLast_ = true;
+            return;
+        }
+
+        uint64_t bytes = totals.bytes - last_.bytes;
+        uint64_t frames = totals.written - last_.written;
+        double writeSeconds = totals.writeSeconds - last_.writeSeconds;
+        double elapsed = std::chrono::duration<double>(now - lastTime_).count();
+        if (bytes == 0 && queued == 0 && lastQueued_ == 0) {
+            lastTime_ = now;
+            return;   // вывода не было
+        }
+
+        if (frames > 0) {
+            decision_.frameBytes = smooth(decision_.frameBytes, static_cast<double>(bytes) / frames);
+        }
+
+        // Затор: очередь терминала не пустела весь интервал (линия
+        // работала без простоя) или write ждал линию
+        double rate = 0;
+        if (queued > 0 && lastQueued_ > 0 && elapsed > 0) {
+            double drained = static_cast<double>(lastQueued_) + static_cast<double>(bytes) - queued;
+            if (drained > 0) rate = drained / elapsed;
+        } else if (writeSeconds > kBlockedWriteSeconds) {
+            rate = static_cast<double>(bytes) / writeSeconds;
+        }
+
+        if (rate > 0) {
+            decision_.bytesPerSec = smooth(decision_.bytesPerSec, rate);
+            freeSamples_ = 0;
+        } else if (++freeSamples_ >= kFreeSamplesToReset) {
+            decision_.bytesPerSec = 0;   // линия снова не ограничивает
+            freeSamples_ = 0;
+        }
+        decide();
+
+        last_ = totals;
+        lastQueued_ = queued;
+        lastTime_ = now;
+    }
+
+    const Decision& decision() const { return decision_; }
+
+    void reset() {
+        decision_ = Decision();
+        hasLast_ = false;
+        freeSamples_ = 0;
+    }
+};
+
+} // namespace ui
+
+#endif // TEXTUI_FRAMEPACER_H
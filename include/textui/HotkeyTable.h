@@ -0,0 +1,118 @@
+#ifndef TEXTUI_HOTKEYTABLE_H
+#define TEXTUI_HOTKEYTABLE_H
+
+#include "Widget.h"
+#include <array>
+#include <vector>
+#include <functional>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+
+namespace ui {
+
+/**
+ * @brief Конфликт горячих клавиш в одной области
+ */
+struct HotkeyConflict {
+    char key;
+    Widget* existing;   // владелец клавиши (остаётся им)
+    Widget* rejected;   // виджет, которому клавиша не досталась
+};
+
+/**
+ * @brief Таблица горячих клавиш области (окна или страницы вкладки)
+ *
+ * Клавиша -> виджет за O(1). Таблица обновляется при добавлении,
+ * удалении, показе и скрытии виджетов; в ней только видимые и
+ * включённые виджеты. Клавиша остаётся за тем, кто занял её
+ * первым; проигравший конфликт виджет запоминается и получает
+ * клавишу, когда владелец скрывается.
+ */
+class HotkeyTable {
+public:
+    static constexpr size_t kSlots = 36;            // A-Z, 0-9
+    static constexpr size_t kMaxWidgetKeys = 32;    // клавиш у одного виджета
+
+    using ConflictHandler = std::function<void(const HotkeyConflict&)>;
+
+private:
+    std::array<Widget*, kSlots> slots_{};
+    std::vector<std::pair<uint8_t, Widget*>> shadowed_;   // проигравшие конфликт
+    ConflictHandler onConflict_;
+
+    static int slotOf(char key) {
+        if (key >= 'a' && key <= 'z') return key - 'a';
+        if (key >= 'A' && key <= 'Z') return key - 'A';
+        if (key >= '0' && key <= '9') return 26 + (key - '0');
+        return -1;
+    }
+
+    void bind(char key, Widget* widget) {
+        int slot = slotOf(key);
+        if (slot < 0) return;
+        Widget*& owner = slots_[slot];
+        if (!owner) {
+            owner = widget;
+            return;
+        }
+        if (owner == widget) return;
+        shadowed_.emplace_back(static_cast<uint8_t>(slot), widget);
+        if (onConflict_) onConflict_(HotkeyConflict{key, owner, widget});
+    }
+
+    // Освободившуюся клавишу получает первый ожидающий виджет
+    void promote(size_t slot) {
+        for (auto it = shadowed_.begin(); it != shadowed_.end(); ++it) {
+            if (it->first == slot) {
+                slots_[slot] = it->second;
+                shadowed_.erase(it);
+                return;
+            }
+        }
+    }
+
+public:
+    void setOnConflict(ConflictHandler handler) { onConflict_ = std::move(handler); }
+
+    // Виджет по клавише (nullptr - клавиша свободна)
+    Widget* find(char key) const {
+        int slot = slotOf(key);
+        return slot >= 0 ? slots_[slot] : nullptr;
+    }
+
+    // Перерегистрировать клавиши виджета по его текущему состоянию
+    void update(Widget* widget) {
+        remove(widget);
+        if (!widget->visible() || !widget->enabled()) return;
+
+        char keys[kMaxWidgetKeys];
+        size_t count = widget->getHotkeys(keys, kMaxWidgetKeys);
+        for (size_t i = 0; i < count; i++) {
+            bind(keys[i], widget);
+        }
+    }
+
+    void remove(Widget* widget) {
+        shadowed_.erase(std::remove_if(shadowed_.begin(), shadowed_.end(),
+                                       [widget](const std::pair<uint8_t, Widget*>& entry) {
+                                           return entry.second == widget;
+                                       }),
+                        shadowed_.end());
+        for (size_t slot = 0; slot < kSlots; slot++) {
+            if (slots_[slot] == widget) {
+                slots_[slot] = nullptr;
+                promote(slot);
+            }
+        }
+    }
+
+    void clear() {
+        slots_.fill(nullptr);
+        shadowed_.clear();
+    }
+};
+
+} // namespace ui
+
+#endif // TEXTUI_HOTKEYTABLE_H
@@ -0,0 +1,324 @@
+#ifndef TEXTUI_INPUTREPLAY_H
+#define TEXTUI_INPUTREPLAY_H
+
+#include "App.h"
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <thread>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <cstdint>
+#include <cerrno>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+namespace ui {
+
+/**
+ * @brief Записанный поток ввода
+ *
+ * Событие - байты одной клавиши и время от начала записи.
+ * Текстовый файл:
+ *
+ *     # textui input trace v1
+ *     <мкс> <байты в hex>
+ *     0 1b5b41
+ *     152034 71
+ */
+struct InputTrace {
+    static constexpr const char* kHeader = "# textui input trace v1";
+
+    struct Event {
+        uint64_t timeUs = 0;
+        std::string bytes;
+    };
+
+    std::vector<Event> events;
+
+    bool save(const std::string& path) const {
+        std::ofstream out(path);
+        if (!out) return false;
+        static const char digits[] = "0123456789abcdef";
+        out << kHeader << '\n';
+        for (const Event& event : events) {
+            out << event.timeUs << ' ';
+            for (char ch : event.bytes) {
+                unsigned char byte = static_cast<unsigned char>(ch);
+                out << digits[byte >> 4] << digits[byte & 0xF];
+            }
+            out << '\n';
+        }
+        return static_cast<bool>(out);
+    }
+
+    bool load(const std::string& path, std::string& error) {
+        events.clear();
+        std::ifstream in(path);
+        if (!in) {
+            error = "cannot open " + path;
+            return false;
+        }
+        std::string line;
+        if (!std::getline(in, line) || line != kHeader) {
+            error = path + ": not an input trace";
+            return false;
+        }
+        int lineNo = 1;
+        while (std::getline(in, line)) {
+            lineNo++;
+            if (line.empty() || line[0] == '#') continue;
+            std::istringstream fields(line);
+            Event event;
+            std::string hex;
+            if (!(fields >> event.timeUs >> hex) || hex.size() % 2 != 0 ||
+                (!events.empty() && event.timeUs < events.back().timeUs)) {
+                error = path + ":" + std::to_string(lineNo) + ": bad event";
+                return false;
+            }
+            for (size_t i = 0; i < hex.size(); i += 2) {
+                int high = hexValue(hex[i]);
+                int low = hexValue(hex[i + 1]);
+                if (high < 0 || low < 0) {
+                    error = path + ":" + std::to_string(lineNo) + ": bad byte";
+                    return false;
+                }
+                event.bytes.push_back(static_cast<char>(high * 16 + low));
+            }
+            events.push_back(std::move(event));
+        }
+        return true;
+    }
+
+    static int hexValue(char ch) {
+        if (ch >= '0' && ch <= '9') return ch - '0';
+        if (ch >= 'a' && ch <= 'f') return ch - 'a' + 10;
+        if (ch >= 'A' && ch <= 'F') return ch - 'A' + 10;
+        return -1;
+    }
+};
+
+/**
+ * @brief Запись ввода в InputTrace
+ *
+ *     ui::InputTraceRecorder trace;
+ *     app.getInput()->setTap(&trace);
+ *     app.run();
+ *     app.getInput()->setTap(nullptr);
+ *     trace.getTrace().save("session.trace");
+ */
+class InputTraceRecorder : public InputTap {
+private:
+    using Clock = std::chrono::steady_clock;
+
+    InputTrace trace_;
+    Clock::time_point start_ = Clock::now();
+    bool started_ = false;
+
+public:
+    void inputRead(const char* bytes, size_t count) override {
+        Clock::time_point now = Clock::now();
+        if (!started_) {
+            start_ = now;
+            started_ = true;
+        }
+        InputTrace::Event event;
+        event.timeUs = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(now - start_).count());
+        event.bytes.assign(bytes, count);
+        trace_.events.push_back(std::move(event));
+    }
+
+    const InputTrace& getTrace() const { return trace_; }
+
+    void clear() {
+        trace_.events.clear();
+        started_ = false;
+    }
+};
+
+// p-й процентиль (0..100) с линейной интерполяцией; 0 - нет значений
+inline double percentileOf(std::vector<uint64_t> values, double p) {
+    if (values.empty()) return 0;
+    std::sort(values.begin(), values.end());
+    if (p <= 0) return static_cast<double>(values.front());
+    if (p >= 100) return static_cast<double>(values.back());
+    double rank = p / 100.0 * static_cast<double>(values.size() - 1);
+    size_t low = static_cast<size_t>(rank);
+    double frac = rank - static_cast<double>(low);
+    if (low + 1 >= values.size()) return static_cast<double>(values[low]);
+    return static_cast<double>(values[low]) +
+           (static_cast<double>(values[low + 1]) - static_cast<double>(values[low])) * frac;
+}
+
+#ifndef _WIN32
+
+// Режим воспроизведения
+enum class ReplayMode {
+    Fast,       // события подряд, без пауз; частота кадров не ограничена
+    RealTime    // с записанными паузами; таймеры и частота кадров как в жизни
+};
+
+struct ReplayReport {
+    struct EventResult {
+        uint64_t latencyUs = 0;       // от записи ввода до готового кадра
+        uint64_t frames = 0;          // кадров выведено
+        uint64_t bytes = 0;           // байт вывода
+    };
+
+    std::vector<EventResult> events;
+    uint64_t frames = 0;
+    uint64_t bytes = 0;
+    double seconds = 0;               // весь прогон
+
+    // Задержка p-го процентиля (0..100), мкс
+    double percentileUs(double p) const {
+        std::vector<uint64_t> values;
+        values.reserve(events.size());
+        for (const EventResult& event : events) values.push_back(event.latencyUs);
+        return percentileOf(std::move(values), p);
+    }
+
+    double meanUs() const {
+        if (events.empty()) return 0;
+        double sum = 0;
+        for (const EventResult& event : events) sum += static_cast<double>(event.latencyUs);
+        return sum / static_cast<double>(events.size());
+    }
+};
+
+/**
+ * @brief Воспроизведение InputTrace в App без терминала
+ *
+ * App инициализируется через initHeadless: клавиши приходят из
+ * канала, кадры собираются, но не выводятся. Каждое событие
+ * записывается в канал целиком, затем кадры крутятся, пока ввод не
+ * разобран и изменения не выведены; задержка события - от записи
+ * до готового кадра. Приложение (окна, виджеты) готовит вызывающий:
+ *
+ *     ui::App app;
+ *     ui::ReplayHarness harness;
+ *     harness.attach(app, 80, 25);
+ *     buildUi(app);
+ *     ui::ReplayReport report = harness.replay(app, trace, ui::ReplayMode::Fast);
+ *     printf("p99 %.0f us\n", report.percentileUs(99));
+ *
+ * Канал закрывается вместе с harness: после этого кадры app не крутят.
+ */
+class ReplayHarness {
+private:
+    using Clock = std::chrono::steady_clock;
+
+    int readFd_ = -1;
+    int writeFd_ = -1;
+
+    void closePipe() {
+        if (readFd_ >= 0) ::close(readFd_);
+        if (writeFd_ >= 0) ::close(writeFd_);
+        readFd_ = writeFd_ = -1;
+    }
+
+    bool writeBytes(const std::string& bytes) {
+        size_t done = 0;
+        while (done < bytes.size()) {
+            ssize_t n = ::write(writeFd_, bytes.data() + done, bytes.size() - done);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) return false;
+            done += static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    // Кадры с выводом (flush, в котором что-то изменилось)
+    static uint64_t framesOut(App& app) { return app.getScreen()->getOutputStats().written; }
+
+public:
+    ReplayHarness() = default;
+    ~ReplayHarness() { closePipe(); }
+
+    ReplayHarness(const ReplayHarness&) = delete;
+    ReplayHarness& operator=(const ReplayHarness&) = delete;
+
+    // Инициализировать app без терминала с экраном width x height
+    bool attach(App& app, int width, int height) {
+        closePipe();
+        int fds[2];
+        if (::pipe(fds) != 0) return false;
+        readFd_ = fds[0];
+        writeFd_ = fds[1];
+        if (!app.initHeadless(width, height, readFd_)) {
+            closePipe();
+            return false;
+        }
+        return true;
+    }
+
+    // Вывести начальный кадр до замеров
+    void settle(App& app) {
+        while (app.hasPendingFrame() || app.getInput()->hasInput()) {
+            app.runFrame();
+        }
+    }
+
+    ReplayReport replay(App& app, const InputTrace& trace, ReplayMode mode = ReplayMode::Fast) {
+        ReplayReport report;
+        if (writeFd_ < 0) return report;
+
+        bool pacing = app.isPacing();
+        app.setPacing(mode == ReplayMode::RealTime);
+        settle(app);
+
+        Screen& screen = *app.getScreen();
+        Input& input = *app.getInput();
+        uint64_t framesBefore = framesOut(app);
+        uint64_t bytesBefore = screen.getOutputStats().bytes;
+        Clock::time_point start = Clock::now();
+        report.events.reserve(trace.events.size());
+
+        for (const InputTrace::Event& event : trace.events) {
+            if (mode == ReplayMode::RealTime) {
+                // Пока ждём событие, главный цикл обслуживает таймеры
+                Clock::time_point due = start + std::chrono::microseconds(event.timeUs);
+                for (;;) {
+                    auto left = std::chrono::duration_cast<std::chrono::milliseconds>(due - Clock::now());
+                    if (left.count() <= 0) break;
+                    if (app.waitTimeoutMs() < left.count()) {
+                        app.runFrame();
+                    } else {
+                        std::this_thread::sleep_until(due);
+                    }
+                }
+            }
+
+            uint64_t frames = framesOut(app);
+            uint64_t bytes = screen.getOutputStats().bytes;
+            Clock::time_point sent = Clock::now();
+            if (!writeBytes(event.bytes)) break;
+            do {
+                app.runFrame();
+            } while (input.hasInput() || app.hasPendingFrame());
+
+            ReplayReport::EventResult result;
+            result.latencyUs = static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - sent).count());
+            result.frames = framesOut(app) - frames;
+            result.bytes = screen.getOutputStats().bytes - bytes;
+            report.events.push_back(result);
+        }
+
+        report.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        report.frames = framesOut(app) - framesBefore;
+        report.bytes = screen.getOutputStats().bytes - bytesBefore;
+        app.setPacing(pacing);
+        return report;
+    }
+};
+
+#endif // _WIN32
+
+} // namespace ui
+
+#endif // TEXTUI_INPUTREPLAY_H
@@ -0,0 +1,273 @@
+#ifndef TEXTUI_ITEMFILTER_H
+#define TEXTUI_ITEMFILTER_H
+
+#include "../core/ThreadPool.h"
+#include <vector>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <memory>
+#include <functional>
+#include <algorithm>
+#include <cctype>
+
+namespace ui {
+
+/**
+ * @brief Фильтр строк списка по подстроке (без учёта регистра)
+ *
+ * Хранит отображение "видимая строка -> индекс элемента" для
+ * ListBox и DropDown. Если новый запрос продолжает предыдущий,
+ * поиск идёт только по прошлому результату. Большие списки
+ * сканируются параллельно в фоновом задании, которое отменяется
+ * следующим запросом, так что ввод не блокирует цикл интерфейса.
+ *
+ * Пока задание выполняется, элементы нельзя менять: владелец
+ * вызывает cancel() перед изменением и refresh() после него.
+ * Добавление в конец задание не прерывает, если вектор не
+ * переразмещается (см. prepareAppend): задание сканирует
+ * элементы, бывшие при запуске, остальные дописывает poll().
+ */
+class ItemFilter {
+public:
+    static constexpr size_t kAsyncThreshold = 20000;     // фоновое задание
+    static constexpr size_t kParallelChunk = 16384;      // элементов на поток
+    static constexpr size_t kCancelCheck = 4096;         // шаг проверки отмены
+
+private:
+    // Фоновое задание фильтрации
+    struct Job {
+        std::atomic<bool> cancelled{false};
+        std::atomic<bool> done{false};
+        std::string query;
+        size_t count = 0;          // сколько элементов сканирует задание
+        std::vector<int> result;
+        std::thread thread;
+    };
+
+    std::string query_;            // текущий запрос
+    std::string resultQuery_;      // запрос, которому соответствует result_
+    std::vector<int> result_;      // индексы подходящих элементов (по возрастанию)
+    bool resultValid_ = false;     // result_ актуален для текущих элементов
+    std::unique_ptr<Job> job_;
+    std::function<void()> onReady_;   // из потока задания, см. setOnReady
+
+    static std::string toLower(const std::string& s) {
+        std::string out(s);
+        for (char& c : out) c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+        return out;
+    }
+
+    static bool matches(const std::string& item, const std::string& lowerQuery) {
+        if (lowerQuery.empty()) return true;
+        auto it = std::search(item.begin(), item.end(), lowerQuery.begin(), lowerQuery.end(),
+                              [](char a, char b) {
+                                  return tolower(static_cast<unsigned char>(a)) == b;
+                              });
+        return it != item.end();
+    }
+
+    // Сканирование кандидатов; base == nullptr - первые count элементов
+    static bool scan(const std::string* items, size_t count, const std::vector<int>* base,
+                     const std::string& lowerQuery, const std::atomic<bool>* cancelled,
+                     std::vector<int>& out) {
+        size_t total = base ? base->size() : count;
+        ThreadPool& pool = ThreadPool::shared();
+        std::vector<std::vector<int>> parts(pool.size() + 1);
+
+        pool.parallelFor(0, total, kParallelChunk, [&](size_t b, size_t e, size_t chunk) {
+            std::vector<int>& part = parts[chunk];
+            for (size_t i = b; i < e; i++) {
+                if (cancelled && ((i - b) % kCancelCheck) == 0 && cancelled->load()) return;
+                int index = base ? (*base)[i] : static_cast<int>(i);
+                if (matches(items[index], lowerQuery)) part.push_back(index);
+            }
+        });
+
+        if (cancelled && cancelled->load()) return false;
+
+        // Части идут по порядку, результат остаётся отсортированным
+        out.clear();
+        for (auto& part : parts) {
+            out.insert(out.end(), part.begin(), part.end());
+        }
+        return true;
+    }
+
+    void finishJob() {
+        if (!job_) return;
+        if (job_->thread.joinable()) job_->thread.join();
+        job_.reset();
+    }
+
+public:
+    ItemFilter() = default;
+    ~ItemFilter() { cancel(); }
+
+    ItemFilter(const ItemFilter&) = delete;
+    ItemFilter& operator=(const ItemFilter&) = delete;
+
+    bool active() const { return !query_.empty(); }
+    const std::string& query() const { return query_; }
+
+    // Идёт фоновая фильтрация (показывается прошлый результат или все элементы)
+    bool pending() const { return job_ != nullptr; }
+
+    /**
+     * @brief Сообщать о готовом результате фонового задания
+     *
+     * Вызывается из потока задания после его завершения; результат
+     * забирает poll() в потоке интерфейса. Подходит Wakeup::notify.
+     */
+    void setOnReady(std::function<void()> onReady) { onReady_ = std::move(onReady); }
+
+    // Остановить фоновое задание (перед изменением элементов)
+    void cancel() {
+        if (!job_) return;
+        job_->cancelled = true;
+        finishJob();
+    }
+
+    /**
+     * @brief Установить запрос
+     * @return true, если результат уже готов (синхронный путь)
+     */
+    bool setQuery(const std::vector<std::string>& items, const std::string& query) {
+        cancel();
+        query_ = query;
+
+        if (query_.empty()) {
+            result_.clear();
+            resultQuery_.clear();
+            resultValid_ = false;
+            return true;
+        }
+
+        std::string lowerQuery = toLower(query_);
+
+        // Уточнение запроса - ищем только среди прошлых совпадений
+        const std::vector<int>* base = nullptr;
+        if (resultValid_ && !resultQuery_.empty() &&
+            lowerQuery.compare(0, resultQuery_.size(), resultQuery_) == 0) {
+            base = &result_;
+        }
+
+        size_t work = base ? base->size() : items.size();
+        if (work < kAsyncThreshold) {
+            std::vector<int> out;
+            scan(items.data(), items.size(), base, lowerQuery, nullptr, out);
+            result_.swap(out);
+            resultQuery_ = lowerQuery;
+            resultValid_ = true;
+            return true;
+        }
+
+        // Фоновое задание; база копируется, result_ продолжает показываться.
+        // Задание читает только первые count элементов по указателю на
+        // данные, поэтому добавление без переразмещения ему не мешает.
+        job_.reset(new Job());
+        job_->query = lowerQuery;
+        job_->count = items.size();
+        Job* job = job_.get();
+        std::vector<int> baseCopy;
+        if (base) baseCopy = *base;
+        bool useBase = base != nullptr;
+        job->thread = std::thread([job, data = items.data(), baseCopy = std::move(baseCopy),
+                                   useBase, onReady = onReady_] {
+            std::vector<int> out;
+            if (scan(data, job->count, useBase ? &baseCopy : nullptr, job->query,
+                     &job->cancelled, out)) {
+                job->result.swap(out);
+            }
+            job->done = true;
+            if (onReady && !job->cancelled) onReady();
+        });
+        return false;
+    }
+
+    /**
+     * @brief Забрать результат фонового задания
+     * Элементы, добавленные после запуска задания, проверяются здесь.
+     * @return true, если набор видимых строк изменился
+     */
+    bool poll(const std::vector<std::string>& items) {
+        if (!job_ || !job_->done) return false;
+        bool ok = !job_->cancelled;
+        if (ok) {
+            result_.swap(job_->result);
+            resultQuery_ = job_->query;
+            resultValid_ = true;
+            for (size_t i = job_->count; i < items.size(); i++) {
+                if (matches(items[i], resultQuery_)) result_.push_back(static_cast<int>(i));
+            }
+        }
+        finishJob();
+        return ok;
+    }
+
+    // Повторить фильтрацию после изменения элементов
+    void refresh(const std::vector<std::string>& items) {
+        resultValid_ = false;
+        if (active()) setQuery(items, query_);
+    }
+
+    /**
+     * @brief Подготовить добавление элемента в конец списка
+     *
+     * Задание прерывается, только если push_back переразместит
+     * элементы. Ёмкость при этом растёт вдвое, так что поток
+     * добавлений перезапускает задание редко и не мешает ему
+     * завершиться.
+     */
+    void prepareAppend(const std::vector<std::string>& items) {
+        if (items.size() == items.capacity()) cancel();
+    }
+
+    /**
+     * @brief Элемент добавлен в конец списка (после prepareAppend())
+     *
+     * Прошлый результат дополняется новым элементом. Идущее задание
+     * продолжается - новый элемент добавит poll(). Если задание
+     * текущего запроса было прервано, результат относится к
+     * предыдущему запросу - текущий запускается заново уточнением.
+     */
+    void itemAppended(const std::vector<std::string>& items) {
+        if (!active()) return;
+        int index = static_cast<int>(items.size()) - 1;
+        if (pending()) {
+            if (resultValid_ && matches(items[index], resultQuery_)) result_.push_back(index);
+            return;
+        }
+        if (!resultValid_) {
+            refresh(items);
+            return;
+        }
+        if (matches(items[index], resultQuery_)) result_.push_back(index);
+        if (resultQuery_ != toLower(query_)) setQuery(items, query_);
+    }
+
+    // Число видимых строк; до первого результата видны все элементы
+    int rowCount(int itemCount) const {
+        if (!active() || !resultValid_) return itemCount;
+        return static_cast<int>(result_.size());
+    }
+
+    // Индекс элемента для видимой строки
+    int rowToItem(int row) const {
+        if (!active() || !resultValid_) return row;
+        if (row < 0 || row >= static_cast<int>(result_.size())) return -1;
+        return result_[row];
+    }
+
+    // Видимая строка элемента (-1, если элемент отфильтрован)
+    int itemToRow(int item) const {
+        if (!active() || !resultValid_) return item;
+        auto it = std::lower_bound(result_.begin(), result_.end(), item);
+        if (it == result_.end() || *it != item) return -1;
+        return static_cast<int>(it - result_.begin());
+    }
+};
+
+} // namespace ui
+
+#endif // TEXTUI_ITEMFILTER_H
@@ -0,0 +1,507 @@
+#ifndef TEXTUI_KEYBINDINGS_H
+#define TEXTUI_KEYBINDINGS_H
+
+#include "Input.h"
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <typeindex>
+#include <typeinfo>
+#include <functional>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <cctype>
+#include <cstdint>
+#include <cstddef>
+
+namespace ui {
+
+// Идентификатор действия в KeyBindings
+using ActionId = uint16_t;
+constexpr ActionId kNoAction = 0xFFFF;
+
+/**
+ * @brief Префиксное дерево сочетаний клавиш
+ *
+ * Узел хранит действие и отсортированные по коду клавиши рёбра,
+ * поэтому шаг по дереву - двоичный поиск без выделения памяти.
+ * Узел с действием и продолжениями (Ctrl+K и Ctrl+K Ctrl+S)
+ * срабатывает по таймауту аккорда.
+ */
+class Keymap {
+public:
+    static constexpr uint32_t kRoot = 0;
+    static constexpr uint32_t kNoNode = 0xFFFFFFFF;
+    static constexpr size_t kMaxChord = 4;
+
+private:
+    struct Edge {
+        int key;
+        uint32_t node;
+    };
+
+    struct Node {
+        ActionId action = kNoAction;
+        std::vector<Edge> edges;   // по возрастанию key
+    };
+
+    std::vector<Node> nodes_;
+
+public:
+    Keymap() : nodes_(1) {}
+
+    /**
+     * @brief Назначить действие последовательности клавиш
+     * @return действие, которое было назначено раньше (kNoAction - не было)
+     */
+    ActionId bind(const Key* keys, size_t count, ActionId action) {
+        if (count == 0 || count > kMaxChord) return kNoAction;
+        uint32_t node = kRoot;
+        for (size_t i = 0; i < count; i++) {
+            int code = static_cast<int>(keys[i]);
+            std::vector<Edge>& edges = nodes_[node].edges;
+            auto it = std::lower_bound(edges.begin(), edges.end(), code,
+                                       [](const Edge& e, int k) { return e.key < k; });
+            if (it != edges.end() && it->key == code) {
+                node = it->node;
+                continue;
+            }
+            uint32_t child = static_cast<uint32_t>(nodes_.size());
+            edges.insert(it, Edge{code, child});
+            nodes_.emplace_back();   // ссылка edges дальше не используется
+            node = child;
+        }
+        ActionId previous = nodes_[node].action;
+        nodes_[node].action = action;
+        return previous;
+    }
+
+    // Снять назначение (узлы остаются, действие сбрасывается)
+    bool unbind(const Key* keys, size_t count) {
+        uint32_t node = kRoot;
+        for (size_t i = 0; i < count && node != kNoNode; i++) {
+            node = step(node, keys[i]);
+        }
+        if (node == kNoNode || node == kRoot || nodes_[node].action == kNoAction) return false;
+        nodes_[node].action = kNoAction;
+        return true;
+    }
+
+    // Переход по клавише (kNoNode - продолжения нет)
+    uint32_t step(uint32_t node, Key key) const {
+        int code = static_cast<int>(key);
+        const std::vector<Edge>& edges = nodes_[node].edges;
+        auto it = std::lower_bound(edges.begin(), edges.end(), code,
+                                   [](const Edge& e, int k) { return e.key < k; });
+        return (it != edges.end() && it->key == code) ? it->node : kNoNode;
+    }
+
+    ActionId action(uint32_t node) const { return nodes_[node].action; }
+    bool isPrefix(uint32_t node) const { return !nodes_[node].edges.empty(); }
+
+    void clear() {
+        nodes_.clear();
+        nodes_.emplace_back();
+    }
+};
+
+/**
+ * @brief Разбор имени клавиши: "q", "F5", "Ctrl+K", "Alt+Enter"
+ */
+inline bool parseKeyName(const std::string& text, Key& out) {
+    std::string name = text;
+    int mods = 0;
+    bool ctrl = false;
+    for (;;) {
+        size_t plus = name.find('+');
+        if (plus == std::string::npos || plus + 1 >= name.size()) break;
+        std::string mod = name.substr(0, plus);
+        for (char& c : mod) c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+        if (mod == "ctrl") ctrl = true;
+        else if (mod == "alt") mods |= static_cast<int>(Key::AltMask);
+        else if (mod == "shift") mods |= static_cast<int>(Key::ShiftMask);
+        else return false;
+        name.erase(0, plus + 1);
+    }
+
+    std::string lower = name;
+    for (char& c : lower) c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+
+    static const struct { const char* name; Key key; } named[] = {
+        {"escape", Key::Escape}, {"esc", Key::Escape}, {"enter", Key::Enter},
+        {"tab", Key::Tab}, {"backspace", Key::Backspace}, {"space", Key::Space},
+        {"up", Key::Up}, {"down", Key::Down}, {"left", Key::Left}, {"right", Key::Right},
+        {"home", Key::Home}, {"end", Key::End}, {"pageup", Key::PageUp},
+        {"pagedown", Key::PageDown}, {"insert", Key::Insert}, {"delete", Key::Delete},
+        {"f1", Key::F1}, {"f2", Key::F2}, {"f3", Key::F3}, {"f4", Key::F4},
+        {"f5", Key::F5}, {"f6", Key::F6}, {"f7", Key::F7}, {"f8", Key::F8},
+        {"f9", Key::F9}, {"f10", Key::F10}, {"f11", Key::F11}, {"f12", Key::F12},
+    };
+
+    Key base = Key::None;
+    for (const auto& entry : named) {
+        if (lower == entry.name) {
+            base = entry.key;
+            break;
+        }
+    }
+    if (base == Key::None) {
+        if (name.size() != 1 || static_cast<unsigned char>(name[0]) < 33 ||
+            static_cast<unsigned char>(name[0]) > 126) {
+            return false;
+        }
+        char ch = name[0];
+        if (ctrl && isalpha(static_cast<unsigned char>(ch))) {
+            // Так Ctrl+буква приходит из Input (см. Ctrl())
+            out = static_cast<Key>(static_cast<int>(Ctrl(ch)) | mods);
+            return true;
+        }
+        base = static_cast<Key>(isalpha(static_cast<unsigned char>(ch))
+                                ? tolower(static_cast<unsigned char>(ch)) : ch);
+    }
+    if (ctrl) mods |= static_cast<int>(Key::CtrlMask);
+    out = static_cast<Key>(static_cast<int>(base) | mods);
+    return true;
+}
+
+/**
+ * @brief Движок назначений клавиш
+ *
+ * Клавиша проходит слои по приоритету:
+ *   1. обработчик (бывший App::setGlobalHotkeyHandler);
+ *   2. раскладка окна (по заголовку);
+ *   3. раскладка типа виджета с фокусом;
+ *   4. общая раскладка.
+ * Аккорд принадлежит слою, в котором нашлась его первая клавиша.
+ * Незавершённый аккорд сбрасывается через chordTimeout; если у
+ * префикса есть собственное действие, оно срабатывает по таймауту.
+ * Разрешение клавиши не выделяет память.
+ */
+class KeyBindings {
+public:
+    using Handler = std::function<bool(Key)>;
+    using Action = std::function<bool()>;
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr int kDefaultChordTimeoutMs = 1000;
+
+    // Где находится фокус
+    struct Context {
+        const std::string* window = nullptr;     // заголовок активного окна
+        std::type_index widget = typeid(void);   // тип виджета с фокусом
+    };
+
+private:
+    struct ActionEntry {
+        std::string name;
+        Action fn;
+    };
+
+    Handler handler_;
+    Keymap global_;
+    std::unordered_map<std::string, Keymap> windows_;
+    std::unordered_map<std::type_index, Keymap> widgets_;
+    std::unordered_map<std::string, std::type_index> widgetTypes_;
+
+    std::vector<ActionEntry> actions_;
+    std::unordered_map<std::string, ActionId> actionIds_;
+
+    // Незавершённый аккорд
+    const Keymap* pendingMap_ = nullptr;
+    uint32_t pendingNode_ = Keymap::kNoNode;
+    Clock::time_point deadline_;
+    std::chrono::milliseconds chordTimeout_{kDefaultChordTimeoutMs};
+
+    bool fire(ActionId id) {
+        if (id >= actions_.size() || !actions_[id].fn) return false;
+        return actions_[id].fn();
+    }
+
+    void startChord(const Keymap* map, uint32_t node, Clock::time_point now) {
+        pendingMap_ = map;
+        pendingNode_ = node;
+        deadline_ = now + chordTimeout_;
+    }
+
+    // Шаг незавершённого аккорда
+    bool continueChord(Key key, const Context& context, Clock::time_point now) {
+        const Keymap* map = pendingMap_;
+        uint32_t prefix = pendingNode_;
+        cancelChord();
+
+        uint32_t node = map->step(prefix, key);
+        if (node != Keymap::kNoNode) {
+            if (map->isPrefix(node)) {
+                startChord(map, node, now);
+            } else {
+                fire(map->action(node));
+            }
+            return true;
+        }
+
+        // Аккорд прерван: префикс с действием срабатывает, клавиша
+        // разбирается заново (не назначенная уходит дальше - виджету);
+        // иначе клавиша поглощается
+        if (map->action(prefix) != kNoAction) {
+            fire(map->action(prefix));
+            return handleKeymaps(key, context, now);
+        }
+        return true;
+    }
+
+    // Раскладки по приоритету (без выделения памяти)
+    size_t collectLayers(const Context& context, const Keymap* (&layers)[3]) const {
+        size_t count = 0;
+        if (context.window) {
+            auto it = windows_.find(*context.window);
+            if (it != windows_.end()) layers[count++] = &it->second;
+        }
+        auto it = widgets_.find(context.widget);
+        if (it != widgets_.end()) layers[count++] = &it->second;
+        layers[count++] = &global_;
+        return count;
+    }
+
+    static std::string trim(const std::string& s) {
+        size_t b = 0;
+        size_t e = s.size();
+        while (b < e && isspace(static_cast<unsigned char>(s[b]))) b++;
+        while (e > b && isspace(static_cast<unsigned char>(s[e - 1]))) e--;
+        return s.substr(b, e - b);
+    }
+
+public:
+    KeyBindings() = default;
+
+    KeyBindings(const KeyBindings&) = delete;
+    KeyBindings& operator=(const KeyBindings&) = delete;
+
+    // Действия
+
+    // Идентификатор действия по имени (создаётся при первом обращении)
+    ActionId action(const std::string& name) {
+        auto it = actionIds_.find(name);
+        if (it != actionIds_.end()) return it->second;
+        ActionId id = static_cast<ActionId>(actions_.size());
+        actions_.push_back(ActionEntry{name, nullptr});
+        actionIds_.emplace(name, id);
+        return id;
+    }
+
+    /**
+     * @brief Задать выполнение действия
+     *
+     * fn возвращает false, если действие сейчас неприменимо: тогда
+     * одиночная клавиша обрабатывается дальше, как будто не назначена.
+     */
+    ActionId setAction(const std::string& name, Action fn) {
+        ActionId id = action(name);
+        actions_[id].fn = std::move(fn);
+        return id;
+    }
+
+    const std::string& actionName(ActionId id) const { return actions_[id].name; }
+    size_t actionCount() const { return actions_.size(); }
+
+    // Раскладки
+
+    Keymap& globalKeymap() { return global_; }
+    Keymap& windowKeymap(const std::string& title) { return windows_[title]; }
+
+    Keymap& widgetKeymap(std::type_index type) { return widgets_[type]; }
+
+    template<typename T>
+    Keymap& widgetKeymap() { return widgets_[std::type_index(typeid(T))]; }
+
+    // Имя типа виджета для секций [widget:Имя] в конфигурации
+    void registerWidgetType(const std::string& name, std::type_index type) {
+        widgetTypes_.insert_or_assign(name, type);
+    }
+
+    template<typename T>
+    void registerWidgetType(const std::string& name) {
+        registerWidgetType(name, std::type_index(typeid(T)));
+    }
+
+    // Назначение в общей раскладке по строке: "Ctrl+K Ctrl+S"
+    bool bind(const std::string& chord, const std::string& actionName) {
+        return bind(global_, chord, actionName);
+    }
+
+    bool bind(Keymap& map, const std::string& chord, const std::string& actionName) {
+        Key keys[Keymap::kMaxChord];
+        size_t count = 0;
+        if (!parseChord(chord, keys, count)) return false;
+        cancelChord();
+        map.bind(keys, count, action(actionName));
+        return true;
+    }
+
+    static bool parseChord(const std::string& text, Key (&keys)[Keymap::kMaxChord], size_t& count) {
+        std::istringstream words(text);
+        std::string word;
+        count = 0;
+        while (words >> word) {
+            if (count == Keymap::kMaxChord || !parseKeyName(word, keys[count])) return false;
+            count++;
+        }
+        return count > 0;
+    }
+
+    // Слой-обработчик с наивысшим приоритетом
+    void setHandler(Handler handler) { handler_ = std::move(handler); }
+
+    void setChordTimeout(int ms) { chordTimeout_ = std::chrono::milliseconds(ms); }
+
+    // Разрешение
+
+    bool isChordPending() const { return pendingMap_ != nullptr; }
+
+    // Момент, когда update() завершит незаконченный аккорд
+    Clock::time_point getChordDeadline() const { return deadline_; }
+
+    void cancelChord() {
+        pendingMap_ = nullptr;
+        pendingNode_ = Keymap::kNoNode;
+    }
+
+    // Все слои: обработчик и раскладки
+    bool handleKey(Key key, const Context& context, Clock::time_point now = Clock::now()) {
+        if (!isChordPending() && handleHandler(key)) return true;
+        return handleKeymaps(key, context, now);
+    }
+
+    // Только слой-обработчик
+    bool handleHandler(Key key) {
+        return handler_ && handler_(key);
+    }
+
+    // Только раскладки
+    bool handleKeymaps(Key key, const Context& context, Clock::time_point now = Clock::now()) {
+        if (isChordPending()) return continueChord(key, context, now);
+
+        const Keymap* layers[3];
+        size_t count = collectLayers(context, layers);
+        for (size_t i = 0; i < count; i++) {
+            uint32_t node = layers[i]->step(Keymap::kRoot, key);
+            if (node == Keymap::kNoNode) continue;
+            if (layers[i]->isPrefix(node)) {
+                startChord(layers[i], node, now);
+                return true;
+            }
+            ActionId id = layers[i]->action(node);
+            if (id != kNoAction && fire(id)) return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Проверить таймаут аккорда (вызывается в каждом кадре)
+     * @return true, если сработало действие префикса
+     */
+    bool update(Clock::time_point now = Clock::now()) {
+        if (!isChordPending() || now < deadline_) return false;
+        ActionId id = pendingMap_->action(pendingNode_);
+        cancelChord();
+        return id != kNoAction && fire(id);
+    }
+
+    /**
+     * @brief Загрузить назначения из текста
+     *
+     *     [global]
+     *     Ctrl+K Ctrl+S = file.save
+     *     Escape        = none        # снять назначение
+     *     [window:Настройки]
+     *     F5 = settings.reload
+     *     [widget:ListBox]
+     *     Ctrl+F = list.find
+     *
+     * Файл с ошибкой не применяется; error - "строка: сообщение".
+     */
+    bool loadConfig(const std::string& text, std::string& error) {
+        struct Entry {
+            Keymap* map;
+            Key keys[Keymap::kMaxChord];
+            size_t count;
+            std::string action;
+        };
+        std::vector<Entry> entries;
+        Keymap* map = &global_;
+        std::istringstream lines(text);
+        std::string line;
+        int lineNo = 0;
+
+        auto fail = [&](const std::string& message) {
+            error = std::to_string(lineNo) + ": " + message;
+            return false;
+        };
+
+        while (std::getline(lines, line)) {
+            lineNo++;
+            size_t hash = line.find('#');
+            if (hash != std::string::npos) line.erase(hash);
+            line = trim(line);
+            if (line.empty()) continue;
+
+            if (line.front() == '[') {
+                if (line.back() != ']') return fail("unterminated section");
+                std::string section = trim(line.substr(1, line.size() - 2));
+                if (section == "global") {
+                    map = &global_;
+                } else if (section.compare(0, 7, "window:") == 0) {
+                    map = &windows_[trim(section.substr(7))];
+                } else if (section.compare(0, 7, "widget:") == 0) {
+                    auto it = widgetTypes_.find(trim(section.substr(7)));
+                    if (it == widgetTypes_.end()) return fail("unknown widget type '" + section.substr(7) + "'");
+                    map = &widgets_[it->second];
+                } else {
+                    return fail("unknown section '" + section + "'");
+                }
+                continue;
+            }
+
+            size_t eq = line.find('=');
+            if (eq == std::string::npos) return fail("expected 'keys = action'");
+            Entry entry;
+            entry.map = map;
+            entry.action = trim(line.substr(eq + 1));
+            if (entry.action.empty()) return fail("empty action");
+            if (!parseChord(trim(line.substr(0, eq)), entry.keys, entry.count)) {
+                return fail("bad key sequence '" + trim(line.substr(0, eq)) + "'");
+            }
+            entries.push_back(entry);
+        }
+
+        cancelChord();
+        for (const Entry& entry : entries) {
+            if (entry.action == "none") {
+                entry.map->unbind(entry.keys, entry.count);
+            } else {
+                entry.map->bind(entry.keys, entry.count, action(entry.action));
+            }
+        }
+        return true;
+    }
+
+    bool loadFile(const std::string& path, std::string& error) {
+        std::ifstream in(path);
+        if (!in) {
+            error = "cannot open " + path;
+            return false;
+        }
+        std::stringstream text;
+        text << in.rdbuf();
+        if (!loadConfig(text.str(), error)) {
+            error = path + ":" + error;
+            return false;
+        }
+        return true;
+    }
+};
+
+} // namespace ui
+
+#endif // TEXTUI_KEYBINDINGS_H
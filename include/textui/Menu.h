@@ -35,18 +35,18 @@ private:
     std::vector<MenuItem> items_;
     int selectedIndex_ = -1;
     bool hasFocus_ = false;
-    ColorAttr highlightColor_;
+    StyleId highlightColor_;
     std::function<void(int)> onSelect_;
 
 public:
     Menu(int x, int y, int width)
         : Widget(x, y, width, 1) {
         canFocus_ = true;
-        highlightColor_ = ColorAttr::biosSelected();
+        highlightColor_ = roleStyleId(ThemeRole::MenuHighlight);
     }
 
     void setHighlightColor(ColorAttr color) {
-        highlightColor_ = color;
+        highlightColor_ = color.styleId();
     }
 
     // Р”РѕР±Р°РІР»РµРЅРёРµ СЌР»РµРјРµРЅС‚Р°
@@ -54,6 +54,7 @@ public:
         items_.push_back(MenuItem(label, action, hotkey));
         height_ = static_cast<int>(items_.size()) + 2;
         if (selectedIndex_ < 0) selectedIndex_ = 0;
+        if (hotkey != '\0') notifyHotkeysChanged();
     }
 
     // Р”РѕР±Р°РІР»РµРЅРёРµ СЂР°Р·РґРµР»РёС‚РµР»СЏ
@@ -66,6 +67,7 @@ public:
         items_.clear();
         selectedIndex_ = -1;
         height_ = 3;
+        notifyHotkeysChanged();
     }
 
     int getSelectedIndex() const { return selectedIndex_; }
@@ -137,6 +139,15 @@ public:
         }
     }
 
+    size_t getHotkeys(char* out, size_t max) const override {
+        size_t count = 0;
+        for (const auto& item : items_) {
+            if (count == max) break;
+            if (!item.separator && item.hotkey != '\0') out[count++] = item.hotkey;
+        }
+        return count;
+    }
+
     bool handleHotkey(char key) override {
         if (!visible_ || !enabled_) return false;
 
@@ -162,9 +173,9 @@ public:
     void draw(Screen& screen) override {
         if (!visible_) return;
 
-        ColorAttr normalColor = ColorAttr::biosMenu();
-        ColorAttr disabledColor = ColorAttr::biosDisabled();
-        ColorAttr color = hasFocus_ ? highlightColor_ : normalColor;
+        StyleId normalColor = roleStyleId(ThemeRole::MenuNormal);
+        StyleId disabledColor = roleStyleId(ThemeRole::MenuDisabled);
+        StyleId color = hasFocus_ ? highlightColor_ : normalColor;
 
         // Р Р°РјРєР°
         screen.drawBox(x_, y_, width_, height_, BoxStyles::thin(), normalColor);
@@ -177,7 +188,7 @@ public:
             if (item.separator) {
                 // Р Р°Р·РґРµР»РёС‚РµР»СЊ
                 screen.drawHLine(x_ + 1, y_ + 1 + static_cast<int>(i), width_ - 2, 
-                                Symbols::separatorH, ColorAttr::normal());
+                                Symbols::separatorH, ThemeRole::MenuText);
                 continue;
             }
 
@@ -202,7 +213,7 @@ public:
                 screen.putString(x_ + 1, y_ + 1 + static_cast<int>(i), line.c_str(), highlightColor_);
             } else {
                 // РћР±С‹С‡РЅС‹Р№ СЌР»РµРјРµРЅС‚
-                ColorAttr itemColor = item.enabled ? normalColor : disabledColor;
+                StyleId itemColor = item.enabled ? normalColor : disabledColor;
                 screen.putString(x_ + 2, y_ + 1 + static_cast<int>(i), line.c_str(), itemColor);
             }
         }
@@ -227,17 +227,17 @@ public:
         if (!visible_) return;
 
         // Р¤РѕРЅ РґРёР°Р»РѕРіР°
-        ColorAttr bgColor = ColorAttr(Color8::White, Color8::Blue);
-        ColorAttr textColor = ColorAttr(Color8::BrightWhite, Color8::Blue);
-        ColorAttr buttonColor = ColorAttr(Color8::Black, Color8::Gray);
-        ColorAttr buttonSelectedColor = ColorAttr(Color8::BrightWhite, Color8::Blue);
+        ThemeRole bgColor = ThemeRole::DialogBackground;
+        ThemeRole textColor = ThemeRole::DialogNormal;
+        ThemeRole buttonColor = ThemeRole::DialogHighlight;
+        ThemeRole buttonSelectedColor = ThemeRole::DialogFocused;
 
         // Р РёСЃСѓРµРј СЂР°РјРєСѓ
         screen.drawBox(x_, y_, width_, height_, BoxStyles::doubleLine(), textColor);
 
         // Р—Р°РіРѕР»РѕРІРѕРє
         std::string title = " " + title_ + " ";
-        screen.putString(x_ + 2, y_, title.c_str(), TextStyle::biosTitle());
+        screen.putString(x_ + 2, y_, title.c_str(), ThemeRole::WindowTitle);
 
         // РРєРѕРЅРєР°
         const char* iconStr = "";
@@ -291,7 +291,7 @@ public:
             bool isSelected = (i == selectedButton_);
             
             std::string btnText = " " + label + " ";
-            ColorAttr btnColor = isSelected ? buttonSelectedColor : buttonColor;
+            ThemeRole btnColor = isSelected ? buttonSelectedColor : buttonColor;
             
             screen.drawBox(buttonX, buttonY, static_cast<int>(btnText.length()) + 2, 3, 
                           BoxStyles::thin(), btnColor);
@@ -125,9 +125,9 @@ public:
     void draw(Screen& screen) override {
         if (!visible_) return;
 
-        ColorAttr normalColor = enabled_ ? ColorAttr::normal() : ColorAttr::biosDisabled();
-        ColorAttr focusColor = enabled_ ? ColorAttr::highlight() : ColorAttr::biosDisabled();
-        ColorAttr color = hasFocus_ ? focusColor : normalColor;
+        ThemeRole normalColor = enabled_ ? ThemeRole::RadioNormal : ThemeRole::RadioDisabled;
+        ThemeRole focusColor = enabled_ ? ThemeRole::RadioFocused : ThemeRole::RadioDisabled;
+        ThemeRole color = hasFocus_ ? focusColor : normalColor;
 
         // Рисуем ( ) или (•)
         const char* radioStr = checked_ ? Symbols::radioOn : Symbols::radioOff;
@@ -137,7 +137,7 @@ public:
             std::string hotkeyText = "[";
             hotkeyText += static_cast<char>(toupper(hotkey_));
             hotkeyText += "]";
-            screen.putString(x_, y_, hotkeyText.c_str(), TextStyle::biosHotkey());
+            screen.putString(x_, y_, hotkeyText.c_str(), ThemeRole::Hotkey);
             screen.putString(x_ + 3, y_, radioStr, color);
             screen.putString(x_ + 7, y_, text_.c_str(), color);
         } else {
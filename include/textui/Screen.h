@@ -5,9 +5,18 @@
 #include <cstdint>
 #include <vector>
 #include <cstring>
+#include <cstddef>
 #include <string>
+#include <chrono>
+#include <algorithm>
+#include "Sgr.h"
+#include "FrameEncoder.h"
+#include "TerminalProbe.h"
+#include "TerminalWriter.h"
 #include "../graphics/Colors.h"
 #include "../graphics/Chars.h"
+#include "../graphics/Palette.h"
+#include <array>
 
 #ifdef _WIN32
 #include <windows.h>
@@ -20,47 +29,29 @@
 namespace ui {
 
 /**
- * @brief Ячейка экрана с полной информацией о стиле
+ * @brief Наблюдатель выведенных кадров (запись сессии и т.п.)
+ *
+ * Вызывается из flush() в потоке интерфейса с кадром целиком,
+ * стили ячеек литеральные. Должен возвращаться быстро.
  */
-struct ScreenCell {
-    char ch = ' ';
-    uint8_t fg : 4;      // Цвет текста (0-15)
-    uint8_t bg : 3;      // Цвет фона (0-7)
-    bool blink : 1;      // Мигание
-    bool bold : 1;       // Жирный
-    bool inverse : 1;    // Инверсия
-    bool underline : 1;  // Подчёркивание
-
-    ScreenCell() : fg(7), bg(0), blink(false), bold(false), inverse(false), underline(false) {}
-
-    bool operator==(const ScreenCell& other) const {
-        return ch == other.ch && fg == other.fg && bg == other.bg && 
-               blink == other.blink && bold == other.bold && 
-               inverse == other.inverse && underline == other.underline;
-    }
-    
-    bool operator!=(const ScreenCell& other) const {
-        return !(*this == other);
-    }
-    
-    // Создать из ColorAttr
-    static ScreenCell fromColorAttr(char c, const ColorAttr& attr) {
-        ScreenCell cell;
-        cell.ch = c;
-        cell.fg = attr.fg & 0x0F;
-        cell.bg = attr.bg & 0x07;
-        cell.blink = attr.blink != 0;
-        return cell;
-    }
+class FrameObserver {
+public:
+    virtual ~FrameObserver() = default;
+    virtual void frameFlushed(const std::vector<ScreenCell>& cells, int width, int height) = 0;
 };
 
 /**
  * @brief Экран с двойной буферизацией и оптимизацией вывода
  * 
  * Использует back buffer для отрисовки, затем отправляет
- * на экран только изменённые ячейки.
+ * на экран только изменённые ячейки. Кадр собирается в буфер
+ * из готовых SGR-последовательностей и выводится одной записью.
  */
 class Screen {
+public:
+    // Символ пустой ячейки слоя: composite() её не копирует
+    static constexpr char kTransparent = '\0';
+
 private:
 #ifdef _WIN32
     HANDLE hOut = INVALID_HANDLE_VALUE;
@@ -77,6 +68,8 @@ private:
     bool termiosSaved = false;
 #endif
     bool initialized = false;
+    bool headless_ = false;
+    int probeTimeoutMs_ = TerminalProbe::kQueryTimeoutMs;
     int width = 80;
     int height = 24;
 
@@ -85,23 +78,43 @@ private:
     std::vector<ScreenCell> backBuffer_;
     bool bufferDirty = true;
     
-    // Текущая позиция курсора для оптимизации
-    int cursorX_ = 0;
-    int cursorY_ = 0;
+    // Сборка вывода кадра
+    FrameEncoder encoder_;
+
+    // Асинхронный вывод: кадр уходит потоку писателя
+    TerminalWriter writer_;
+    bool asyncOutput_ = false;
+    std::vector<ScreenCell> snapshot_;
+
+    // Счётчики синхронного вывода (асинхронный считает писатель)
+    TerminalWriter::Stats syncStats_;
+
+    FrameObserver* observer_ = nullptr;
+
+    // Кадр с литеральными стилями в snapshot_
+    void resolveSnapshot() {
+        snapshot_.resize(backBuffer_.size());
+        for (size_t i = 0; i < backBuffer_.size(); i++) {
+            snapshot_[i].ch = backBuffer_[i].ch;
+            snapshot_[i].style = resolve(backBuffer_[i].style);
+        }
+    }
+
+    // Палитра ролей; роли с изменённым стилем перекодируются при выводе
+    Palette palette_;
+    std::array<bool, kRoleCount> roleDirty_{};
+    bool paletteDirty_ = false;
+
+    // Литеральный стиль ячейки
+    StyleId resolve(StyleId style) const {
+        return isRoleStyle(style) ? palette_[styleRole(style)] : style;
+    }
 
     // Получить индекс в буфере
     inline size_t index(int x, int y) const {
         return static_cast<size_t>(y) * width + x;
     }
     
-    // Переместить курсор с оптимизацией
-    void moveCursor(int x, int y) {
-        if (x == cursorX_ && y == cursorY_) return;
-        printf("\033[%d;%dH", y + 1, x + 1);
-        cursorX_ = x;
-        cursorY_ = y;
-    }
-
 public:
     Screen() = default;
     ~Screen() { shutdown(); }
@@ -138,6 +151,7 @@ public:
         width = 80;
         height = 25;
 #endif
+        setTerminalFeatures(TerminalProbe::detect(probeTimeoutMs_));
         // Инициализируем буферы
         size_t size = static_cast<size_t>(width) * height;
         frontBuffer_.resize(size);
@@ -153,9 +167,34 @@ public:
         return true;
     }
 
+    /**
+     * @brief Экран без терминала
+     *
+     * Кадры собираются и считаются (getOutputStats) как обычно, но
+     * никуда не выводятся; режимы консоли не трогаются. Для прогонов
+     * без терминала (InputReplay).
+     */
+    bool initHeadless(int w, int h) {
+        if (initialized || w <= 0 || h <= 0) return false;
+        width = w;
+        height = h;
+        size_t size = static_cast<size_t>(width) * height;
+        frontBuffer_.assign(size, ScreenCell{});
+        backBuffer_.assign(size, ScreenCell{});
+        headless_ = true;
+        initialized = true;
+        return true;
+    }
+
     // Завершение работы
     void shutdown() {
         if (!initialized) return;
+        setAsyncOutput(false);
+        if (headless_) {
+            headless_ = false;
+            initialized = false;
+            return;
+        }
 
 #ifdef _WIN32
         SetConsoleMode(hOut, originalOutMode);
@@ -176,13 +215,17 @@ public:
     
     // Очистка с цветом
     void clear(const ColorAttr& color) {
+        clear(color.styleId());
+    }
+
+    // Очистка ролью темы (фон следует за палитрой)
+    void clear(ThemeRole role) {
+        clear(roleStyleId(role));
+    }
+
+    void clear(StyleId style) {
         ScreenCell cell;
-        cell.fg = color.fg;
-        cell.bg = color.bg;
-        cell.blink = color.blink;
-        cell.bold = false;
-        cell.inverse = false;
-        cell.underline = false;
+        cell.style = style;
         
         for (size_t i = 0; i < frontBuffer_.size(); i++) {
             frontBuffer_[i] = cell;
@@ -193,40 +236,25 @@ public:
 
     // Показать/скрыть курсор
     void showCursor(bool visible) {
-        if (visible) {
-            printf("\033[?25h");
-        } else {
-            printf("\033[?25l");
+        sendControl(visible ? "\033[?25h" : "\033[?25l");
+    }
+
+    // Служебная последовательность в общем потоке вывода: с асинхронным
+    // выводом - через TerminalWriter, не посреди кадра
+    void sendControl(const char* sequence) {
+        if (headless_) return;
+        if (asyncOutput_) {
+            writer_.sendControl(sequence);
+            return;
         }
+        fputs(sequence, stdout);
         fflush(stdout);
     }
 
-    // Установка стиля текста
+    // Установка стиля текста (готовая последовательность из таблицы)
     void setStyle(const TextStyle& style) {
-        uint8_t fg = style.color.fg;
-        uint8_t bg = style.color.bg;
-        bool blink = style.color.blink;
-        bool bold = (style.attr & TextAttr::Bold) != TextAttr::None;
-        bool inverse = (style.attr & TextAttr::Inverse) != TextAttr::None;
-        bool underline = (style.attr & TextAttr::Underline) != TextAttr::None;
-
-        // ANSI color mapping (0-15)
-        static const int fg_map[] = {30, 34, 32, 36, 31, 35, 33, 37, 
-                                     90, 94, 92, 96, 91, 95, 93, 97};
-        static const int bg_map[] = {40, 44, 42, 46, 41, 45, 43, 47};
-
-        printf("\033[0");  // Reset
-        
-        if (bold) printf(";1");
-        if (underline) printf(";4");
-        if (inverse) printf(";7");
-        if (blink) printf(";5");
-        
-        printf(";%dm", fg_map[fg & 0x0F]);
-        
-        if (bg < 8) {
-            printf("\033[%dm", bg_map[bg]);
-        }
+        const SgrCode& seq = kSgrTable[style.styleId()];
+        fwrite(seq.text, 1, seq.length, stdout);
     }
 
     // Сброс стиля
@@ -234,54 +262,164 @@ public:
         printf("\033[0m");
     }
 
-    // Установка символа в буфер
-    void putChar(int x, int y, char ch, const TextStyle& style) {
+    /**
+     * @brief Палитра ролей темы
+     *
+     * Ячейки, нарисованные ролью, при следующем flush() выводятся
+     * заново со стилями новой палитры - перерисовка виджетов
+     * не требуется.
+     */
+    void setPalette(const Palette& palette) {
+        for (size_t i = 0; i < kRoleCount; i++) {
+            if (palette[i] != palette_[i]) {
+                roleDirty_[i] = true;
+                paletteDirty_ = true;
+            }
+        }
+        palette_ = palette;
+        if (paletteDirty_) bufferDirty = true;
+    }
+
+    const Palette& getPalette() const { return palette_; }
+
+    // Установка символа в буфер (стиль или роль, см. roleStyleId)
+    void putChar(int x, int y, char ch, StyleId style) {
         if (x < 0 || x >= width || y < 0 || y >= height) return;
 
-        size_t idx = index(x, y);
-        ScreenCell& cell = backBuffer_[idx];
+        ScreenCell& cell = backBuffer_[index(x, y)];
         cell.ch = ch;
-        cell.fg = style.color.fg;
-        cell.bg = style.color.bg;
-        cell.blink = style.color.blink;
-        cell.bold = (style.attr & TextAttr::Bold) != TextAttr::None;
-        cell.inverse = (style.attr & TextAttr::Inverse) != TextAttr::None;
-        cell.underline = (style.attr & TextAttr::Underline) != TextAttr::None;
+        cell.style = style;
         bufferDirty = true;
     }
 
+    void putChar(int x, int y, char ch, const TextStyle& style) {
+        putChar(x, y, ch, style.styleId());
+    }
+
     // Установка символа с цветом
     void putChar(int x, int y, char ch, const ColorAttr& color) {
-        TextStyle style(color);
-        putChar(x, y, ch, style);
+        putChar(x, y, ch, color.styleId());
     }
 
-    // Установка строки в буфер
-    void putString(int x, int y, const char* str, const TextStyle& style) {
-        if (!str) return;
-        int cx = x;
-        while (*str && cx < width) {
-            putChar(cx++, y, *str++, style);
+    void putChar(int x, int y, char ch, ThemeRole role) {
+        putChar(x, y, ch, roleStyleId(role));
+    }
+
+    // Установка строки в буфер (обрезка по экрану один раз)
+    void putString(int x, int y, const char* str, StyleId style) {
+        if (!str || y < 0 || y >= height) return;
+        while (*str && x < 0) {
+            str++;
+            x++;
+        }
+        ScreenCell* row = &backBuffer_[index(0, y)];
+        bool wrote = false;
+        for (; *str && x < width; str++, x++) {
+            row[x].ch = *str;
+            row[x].style = style;
+            wrote = true;
         }
+        if (wrote) bufferDirty = true;
+    }
+
+    void putString(int x, int y, const char* str, const TextStyle& style) {
+        putString(x, y, str, style.styleId());
     }
     
     // Установка строки с цветом
     void putString(int x, int y, const char* str, const ColorAttr& color) {
-        TextStyle style(color);
-        putString(x, y, str, style);
+        putString(x, y, str, color.styleId());
+    }
+
+    void putString(int x, int y, const char* str, ThemeRole role) {
+        putString(x, y, str, roleStyleId(role));
     }
     
     // Установка строки std::string
     void putString(int x, int y, const std::string& str, const TextStyle& style) {
-        putString(x, y, str.c_str(), style);
+        putString(x, y, str.c_str(), style.styleId());
     }
     
     void putString(int x, int y, const std::string& str, const ColorAttr& color) {
-        putString(x, y, str.c_str(), color);
+        putString(x, y, str.c_str(), color.styleId());
+    }
+
+    void putString(int x, int y, const std::string& str, ThemeRole role) {
+        putString(x, y, str.c_str(), roleStyleId(role));
+    }
+
+    void putString(int x, int y, const std::string& str, StyleId style) {
+        putString(x, y, str.c_str(), style);
+    }
+
+    /**
+     * @brief Заполнить отрезок строки y одной ячейкой
+     *
+     * Отрезок обрезается по экрану один раз, затем ячейки пишутся
+     * подряд (std::fill). Основа fillRect, линий и рамок.
+     */
+    void fillSpan(int x, int y, int w, char ch, StyleId style) {
+        if (y < 0 || y >= height || w <= 0) return;
+        long long end = static_cast<long long>(x) + w;
+        int from = x < 0 ? 0 : x;
+        int to = end > width ? width : static_cast<int>(end);
+        if (from >= to) return;
+        ScreenCell cell;
+        cell.ch = ch;
+        cell.style = style;
+        auto row = backBuffer_.begin() + static_cast<std::ptrdiff_t>(index(0, y));
+        std::fill(row + from, row + to, cell);
+        bufferDirty = true;
+    }
+
+    void fillSpan(int x, int y, int w, char ch, const ColorAttr& color) {
+        fillSpan(x, y, w, ch, color.styleId());
+    }
+
+    void fillSpan(int x, int y, int w, char ch, ThemeRole role) {
+        fillSpan(x, y, w, ch, roleStyleId(role));
+    }
+
+    // Заполнить отрезок столбца x одной ячейкой
+    void fillColumn(int x, int y, int h, char ch, StyleId style) {
+        if (x < 0 || x >= width || h <= 0) return;
+        long long end = static_cast<long long>(y) + h;
+        int from = y < 0 ? 0 : y;
+        int to = end > height ? height : static_cast<int>(end);
+        if (from >= to) return;
+        ScreenCell cell;
+        cell.ch = ch;
+        cell.style = style;
+        for (int iy = from; iy < to; iy++) backBuffer_[index(x, iy)] = cell;
+        bufferDirty = true;
+    }
+
+    /**
+     * @brief Наложить прямоугольник слоя на экран
+     *
+     * Слой - отдельный Screen того же размера (App::setParallelDraw).
+     * Копируются ячейки прямоугольника x, y, w, h, кроме kTransparent:
+     * там остаётся то, что было на экране под слоем.
+     */
+    void composite(const Screen& layer, int x, int y, int w, int h) {
+        int fromX = x < 0 ? 0 : x;
+        int fromY = y < 0 ? 0 : y;
+        long long endX = static_cast<long long>(x) + w;
+        long long endY = static_cast<long long>(y) + h;
+        int toX = static_cast<int>(std::min<long long>(endX, std::min(width, layer.width)));
+        int toY = static_cast<int>(std::min<long long>(endY, std::min(height, layer.height)));
+        for (int iy = fromY; iy < toY; iy++) {
+            const ScreenCell* src = &layer.backBuffer_[layer.index(0, iy)];
+            ScreenCell* dst = &backBuffer_[index(0, iy)];
+            for (int ix = fromX; ix < toX; ix++) {
+                if (src[ix].ch != kTransparent) dst[ix] = src[ix];
+            }
+        }
+        if (fromX < toX && fromY < toY) bufferDirty = true;
     }
 
     // Рисование рамки
-    void drawBox(int x, int y, int w, int h, const BoxStyle& box, const TextStyle& style) {
+    void drawBox(int x, int y, int w, int h, const BoxStyle& box, StyleId style) {
         if (w < 2 || h < 2) return;
 
         // Углы
@@ -290,90 +428,255 @@ public:
         putString(x, y + h - 1, box.bottom_left, style);
         putString(x + w - 1, y + h - 1, box.bottom_right, style);
 
-        // Горизонтальные линии
-        for (int i = 1; i < w - 1; i++) {
-            putString(x + i, y, box.horizontal, style);
-            putString(x + i, y + h - 1, box.horizontal, style);
-        }
+        // Линии между углами
+        drawHLine(x + 1, y, w - 2, box.horizontal, style);
+        drawHLine(x + 1, y + h - 1, w - 2, box.horizontal, style);
+        drawVLine(x, y + 1, h - 2, box.vertical, style);
+        drawVLine(x + w - 1, y + 1, h - 2, box.vertical, style);
+    }
 
-        // Вертикальные линии
-        for (int i = 1; i < h - 1; i++) {
-            putString(x, y + i, box.vertical, style);
-            putString(x + w - 1, y + i, box.vertical, style);
-        }
+    void drawBox(int x, int y, int w, int h, const BoxStyle& box, const TextStyle& style) {
+        drawBox(x, y, w, h, box, style.styleId());
     }
     
     // Рисование рамки с цветом
     void drawBox(int x, int y, int w, int h, const BoxStyle& box, const ColorAttr& color) {
-        TextStyle style(color);
-        drawBox(x, y, w, h, box, style);
+        drawBox(x, y, w, h, box, color.styleId());
+    }
+
+    void drawBox(int x, int y, int w, int h, const BoxStyle& box, ThemeRole role) {
+        drawBox(x, y, w, h, box, roleStyleId(role));
     }
 
     // Рисование заполненного прямоугольника
-    void fillRect(int x, int y, int w, int h, char ch, const ColorAttr& color) {
-        TextStyle style(color);
+    void fillRect(int x, int y, int w, int h, char ch, StyleId style) {
         for (int iy = 0; iy < h; iy++) {
-            for (int ix = 0; ix < w; ix++) {
-                putChar(x + ix, y + iy, ch, style);
-            }
+            fillSpan(x, y + iy, w, ch, style);
         }
     }
 
-    // Рисование горизонтальной линии
-    void drawHLine(int x, int y, int w, const char* ch, const ColorAttr& color) {
-        TextStyle style(color);
+    void fillRect(int x, int y, int w, int h, char ch, const ColorAttr& color) {
+        fillRect(x, y, w, h, ch, color.styleId());
+    }
+
+    void fillRect(int x, int y, int w, int h, char ch, ThemeRole role) {
+        fillRect(x, y, w, h, ch, roleStyleId(role));
+    }
+
+    // Рисование горизонтальной линии (ch - символ; длиннее - по строке на шаг)
+    void drawHLine(int x, int y, int w, const char* ch, StyleId style) {
+        if (!ch || !*ch) return;
+        if (!ch[1]) {
+            fillSpan(x, y, w, *ch, style);
+            return;
+        }
         for (int i = 0; i < w; i++) {
             putString(x + i, y, ch, style);
         }
     }
+
+    void drawHLine(int x, int y, int w, const char* ch, const ColorAttr& color) {
+        drawHLine(x, y, w, ch, color.styleId());
+    }
+
+    void drawHLine(int x, int y, int w, const char* ch, ThemeRole role) {
+        drawHLine(x, y, w, ch, roleStyleId(role));
+    }
     
     // Рисование вертикальной линии
-    void drawVLine(int x, int y, int h, const char* ch, const ColorAttr& color) {
-        TextStyle style(color);
+    void drawVLine(int x, int y, int h, const char* ch, StyleId style) {
+        if (!ch || !*ch) return;
+        if (!ch[1]) {
+            fillColumn(x, y, h, *ch, style);
+            return;
+        }
         for (int i = 0; i < h; i++) {
             putString(x, y + i, ch, style);
         }
     }
 
-    // Отрисовка изменений на экран
-    void flush() {
-        if (!bufferDirty) return;
+    void drawVLine(int x, int y, int h, const char* ch, const ColorAttr& color) {
+        drawVLine(x, y, h, ch, color.styleId());
+    }
+
+    void drawVLine(int x, int y, int h, const char* ch, ThemeRole role) {
+        drawVLine(x, y, h, ch, roleStyleId(role));
+    }
+
+    /**
+     * @brief Асинхронный вывод через поток TerminalWriter
+     *
+     * flush() только копирует кадр в слот писателя и не ждёт
+     * терминала; на медленных линиях промежуточные кадры
+     * пропускаются. При выключении поток дописывает последний кадр.
+     */
+    void setAsyncOutput(bool enable) {
+        if (enable == asyncOutput_ || (enable && headless_)) return;
+        if (enable) {
+            fflush(stdout);
+            std::vector<ScreenCell> shown(frontBuffer_.size());
+            for (size_t i = 0; i < shown.size(); i++) {
+                shown[i].ch = frontBuffer_[i].ch;
+                shown[i].style = resolve(frontBuffer_[i].style);
+            }
+            writer_.start(shown);
+            asyncOutput_ = true;
+        } else {
+            writer_.stop();
+            // Отправленное хранит литеральные стили: ячейки ролей
+            // выведутся заново при следующем flush()
+            if (writer_.getSent().size() == frontBuffer_.size()) {
+                frontBuffer_ = writer_.getSent();
+            }
+            encoder_.invalidateCursor();
+            asyncOutput_ = false;
+            bufferDirty = true;
+        }
+    }
+
+    bool isAsyncOutput() const { return asyncOutput_; }
+
+    // Счётчики вывода за сессию (синхронный и асинхронный вместе)
+    TerminalWriter::Stats getOutputStats() const {
+        TerminalWriter::Stats stats = writer_.getStats();
+        stats.submitted += syncStats_.submitted;
+        stats.written += syncStats_.written;
+        stats.bytes += syncStats_.bytes;
+        stats.writeSeconds += syncStats_.writeSeconds;
+        if (!asyncOutput_) stats.queuedBytes = queuedOutputBytes();
+        return stats;
+    }
+
+    // Байт в очереди вывода терминала (0 - пусто или неизвестно)
+    int queuedOutputBytes() const {
+#ifdef _WIN32
+        return 0;
+#else
+        if (headless_) return 0;
+        return TerminalWriter::queuedOutputBytes(STDOUT_FILENO);
+#endif
+    }
 
-        for (int y = 0; y < height; y++) {
+    // Наблюдатель кадров (nullptr - снять)
+    void setFrameObserver(FrameObserver* observer) { observer_ = observer; }
+    FrameObserver* getFrameObserver() const { return observer_; }
+
+    // Гранулярность разницы, см. FrameEncoder::setGapLimit
+    void setGapLimit(int cells) {
+        encoder_.setGapLimit(cells);
+        writer_.setGapLimit(cells);
+    }
+
+    int getGapLimit() const { return encoder_.getGapLimit(); }
+
+    /**
+     * @brief Профиль терминала: команды сжатия (REP, ECH/EL), синхронный вывод
+     * init() берёт его у TerminalProbe; экран без терминала их не использует.
+     */
+    void setTerminalFeatures(const TerminalFeatures& features) {
+        encoder_.setFeatures(features);
+        writer_.setFeatures(features);
+    }
+
+    const TerminalFeatures& getTerminalFeatures() const { return encoder_.getFeatures(); }
+
+    // Ожидание ответов терминала в init() (0 - профиль без запросов и кэша), см. TerminalProbe
+    void setProbeTimeout(int ms) { probeTimeoutMs_ = ms > 0 ? ms : 0; }
+    int getProbeTimeout() const { return probeTimeoutMs_; }
+
+    // Собирать большие кадры полосами на пуле, см. FrameEncoder::encodeRows
+    void setParallelEncode(bool enable) {
+        encoder_.setParallel(enable);
+        writer_.setParallelEncode(enable);
+    }
+
+    bool isParallelEncode() const { return encoder_.isParallel(); }
+
+    /**
+     * @brief Собрать изменения строк [fromY, toY) и перенести их в front buffer
+     * Меняет только эти строки: полосы кадра собираются параллельно.
+     */
+    void encodeRows(FrameEncoder& encoder, int fromY, int toY) {
+        for (int y = fromY; y < toY; y++) {
             for (int x = 0; x < width; x++) {
                 size_t idx = index(x, y);
-                if (backBuffer_[idx] != frontBuffer_[idx]) {
-                    moveCursor(x, y);
-
-                    // Применяем стиль
-                    TextStyle style;
-                    style.color.fg = backBuffer_[idx].fg;
-                    style.color.bg = backBuffer_[idx].bg;
-                    style.color.blink = backBuffer_[idx].blink;
-                    style.attr = TextAttr::None;
-                    if (backBuffer_[idx].bold) style.attr = style.attr | TextAttr::Bold;
-                    if (backBuffer_[idx].inverse) style.attr = style.attr | TextAttr::Inverse;
-                    if (backBuffer_[idx].underline) style.attr = style.attr | TextAttr::Underline;
-                    
-                    setStyle(style);
-                    putchar(backBuffer_[idx].ch);
+                const ScreenCell& cell = backBuffer_[idx];
+                bool changed = cell != frontBuffer_[idx];
+                // После смены палитры выводятся и неизменённые ячейки её ролей
+                if (!changed && paletteDirty_ && isRoleStyle(cell.style)) {
+                    changed = roleDirty_[styleRole(cell.style)];
+                }
+                if (changed) {
+                    auto literal = [this](StyleId style) { return resolve(style); };
+                    encoder.advanceTo(x, y, &frontBuffer_[index(0, y)], literal);
+                    encoder.applyStyle(resolve(cell.style));
+                    int count = encoder.emitRun(x, y, &backBuffer_[index(0, y)], width, literal);
 
                     // Копируем в front buffer
-                    frontBuffer_[idx] = backBuffer_[idx];
+                    std::copy(backBuffer_.begin() + idx, backBuffer_.begin() + idx + count,
+                              frontBuffer_.begin() + idx);
+                    x += count - 1;
                 }
             }
         }
+    }
 
-        resetStyle();
-        fflush(stdout);
+    // Отрисовка изменений на экран
+    void flush() {
+        if (!bufferDirty) return;
+
+        if (observer_ || asyncOutput_) {
+            resolveSnapshot();
+            if (observer_) observer_->frameFlushed(snapshot_, width, height);
+        }
+
+        if (asyncOutput_) {
+            writer_.submit(snapshot_, width, height);
+            bufferDirty = false;
+            if (paletteDirty_) {
+                roleDirty_.fill(false);
+                paletteDirty_ = false;
+            }
+            return;
+        }
+
+        encoder_.begin(width);
+        encoder_.encodeRows(height, [this](FrameEncoder& encoder, int fromY, int toY) {
+            encodeRows(encoder, fromY, toY);
+        });
+
+        const std::string& out = encoder_.finish();
+        if (!out.empty()) {
+            auto started = std::chrono::steady_clock::now();
+            if (!headless_) {
+                fwrite(out.data(), 1, out.size(), stdout);
+                fflush(stdout);
+            }
+            syncStats_.writeSeconds += std::chrono::duration<double>(
+                std::chrono::steady_clock::now() - started).count();
+            syncStats_.bytes += out.size();
+            syncStats_.submitted++;
+            syncStats_.written++;
+        }
         bufferDirty = false;
+        if (paletteDirty_) {
+            roleDirty_.fill(false);
+            paletteDirty_ = false;
+        }
     }
 
     // Принудительная перерисовка всего экрана
     void forceRedraw() {
+        if (asyncOutput_) {
+            writer_.resendAll();
+            bufferDirty = true;
+            flush();
+            return;
+        }
         for (size_t i = 0; i < frontBuffer_.size(); i++) {
             frontBuffer_[i].ch = '\0';  // Force mismatch
         }
+        encoder_.invalidateCursor();
         bufferDirty = true;
         flush();
     }
@@ -382,6 +685,7 @@ public:
     int getWidth() const { return width; }
     int getHeight() const { return height; }
     bool isInitialized() const { return initialized; }
+    bool isHeadless() const { return headless_; }
     
     // Получить ячейку из back buffer
     const ScreenCell& getCell(int x, int y) const {
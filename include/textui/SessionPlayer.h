@@ -0,0 +1,175 @@
+#ifndef TEXTUI_SESSIONPLAYER_H
+#define TEXTUI_SESSIONPLAYER_H
+
+#include "SessionRecorder.h"
+#include <string>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+
+namespace ui {
+
+/**
+ * @brief Воспроизведение записи SessionRecorder
+ *
+ * Кадры восстанавливаются по одному (next) и выводятся через любой
+ * Screen: ячейки копируются в его буфер, вывод делает flush().
+ */
+class SessionPlayer {
+private:
+    FILE* file_ = nullptr;
+    uint64_t startTime_ = 0;      // мкс Unix
+    std::vector<ScreenCell> cells_;
+    int width_ = 0;
+    int height_ = 0;
+    uint64_t delayUs_ = 0;        // пауза перед текущим кадром
+    uint64_t elapsedUs_ = 0;      // от начала записи до текущего кадра
+    uint64_t frame_ = 0;
+    std::string error_;
+
+    bool fail(const std::string& message) {
+        error_ = message;
+        return false;
+    }
+
+    bool readFrame() {
+        uint64_t delay = 0;
+        uint64_t runs = 0;
+        if (!SessionFormat::getVarint(file_, delay) || !SessionFormat::getVarint(file_, runs)) {
+            return fail("truncated frame header");
+        }
+
+        size_t pos = 0;
+        for (uint64_t r = 0; r < runs; r++) {
+            uint64_t skip = 0;
+            uint64_t length = 0;
+            uint64_t style = 0;
+            if (!SessionFormat::getVarint(file_, skip) || !SessionFormat::getVarint(file_, length) ||
+                !SessionFormat::getVarint(file_, style)) {
+                return fail("truncated run");
+            }
+            pos += skip;
+            if (pos + length > cells_.size() || style >= kStyleCount) return fail("run out of range");
+            for (uint64_t k = 0; k < length; k++) {
+                int ch = fgetc(file_);
+                if (ch == EOF) return fail("truncated run");
+                cells_[pos].ch = static_cast<char>(ch);
+                cells_[pos].style = static_cast<StyleId>(style);
+                pos++;
+            }
+        }
+        delayUs_ = delay;
+        elapsedUs_ += delay;
+        frame_++;
+        return true;
+    }
+
+public:
+    SessionPlayer() = default;
+    ~SessionPlayer() { close(); }
+
+    SessionPlayer(const SessionPlayer&) = delete;
+    SessionPlayer& operator=(const SessionPlayer&) = delete;
+
+    bool open(const std::string& path) {
+        close();
+        error_.clear();
+        file_ = fopen(path.c_str(), "rb");
+        if (!file_) return fail("cannot open " + path);
+
+        char magic[SessionFormat::kMagicLength];
+        if (fread(magic, 1, sizeof(magic), file_) != sizeof(magic) ||
+            std::string(magic, sizeof(magic)) != std::string(SessionFormat::kMagic, sizeof(magic))) {
+            close();
+            return fail(path + ": not a session recording");
+        }
+        if (!SessionFormat::getVarint(file_, startTime_)) {
+            close();
+            return fail(path + ": truncated header");
+        }
+        return true;
+    }
+
+    void close() {
+        if (file_) {
+            fclose(file_);
+            file_ = nullptr;
+        }
+        cells_.clear();
+        width_ = height_ = 0;
+        delayUs_ = elapsedUs_ = frame_ = 0;
+    }
+
+    /**
+     * @brief Восстановить следующий кадр
+     * @return false - конец записи или ошибка (см. getError)
+     */
+    bool next() {
+        if (!file_) return false;
+        for (;;) {
+            int tag = fgetc(file_);
+            if (tag == EOF) return false;
+            if (tag == SessionFormat::kFrameTag) {
+                if (cells_.empty()) return fail("frame before size");
+                return readFrame();
+            }
+            if (tag != SessionFormat::kSizeTag) return fail("unknown record");
+
+            uint64_t width = 0;
+            uint64_t height = 0;
+            if (!SessionFormat::getVarint(file_, width) || !SessionFormat::getVarint(file_, height) ||
+                width == 0 || height == 0 || width * height > (1u << 24)) {
+                return fail("bad size record");
+            }
+            width_ = static_cast<int>(width);
+            height_ = static_cast<int>(height);
+            cells_.assign(static_cast<size_t>(width * height), ScreenCell{});
+        }
+    }
+
+    // Перенести текущий кадр в screen и вывести (лишнее обрезается)
+    void render(Screen& screen) const {
+        int width = width_ < screen.getWidth() ? width_ : screen.getWidth();
+        int height = height_ < screen.getHeight() ? height_ : screen.getHeight();
+        for (int y = 0; y < height; y++) {
+            const ScreenCell* row = &cells_[static_cast<size_t>(y) * width_];
+            for (int x = 0; x < width; x++) {
+                screen.putChar(x, y, row[x].ch, row[x].style);
+            }
+        }
+        screen.flush();
+    }
+
+    /**
+     * @brief Проиграть запись до конца
+     * @param speed множитель скорости (2 - вдвое быстрее); 0 - без пауз
+     * @return число показанных кадров
+     */
+    uint64_t play(Screen& screen, double speed = 1.0) {
+        uint64_t shown = 0;
+        while (next()) {
+            if (speed > 0 && delayUs_ > 0) {
+                std::this_thread::sleep_for(std::chrono::microseconds(
+                    static_cast<int64_t>(static_cast<double>(delayUs_) / speed)));
+            }
+            render(screen);
+            shown++;
+        }
+        return shown;
+    }
+
+    const std::vector<ScreenCell>& getCells() const { return cells_; }
+    int getWidth() const { return width_; }
+    int getHeight() const { return height_; }
+    uint64_t getStartTime() const { return startTime_; }
+    uint64_t getFrameDelayUs() const { return delayUs_; }
+    uint64_t getElapsedUs() const { return elapsedUs_; }
+    uint64_t getFrameIndex() const { return frame_; }
+    const std::string& getError() const { return error_; }
+};
+
+} // namespace ui
+
+#endif // TEXTUI_SESSIONPLAYER_H
@@ -0,0 +1,105 @@
+#ifndef TEXTUI_SPSCRING_H
+#define TEXTUI_SPSCRING_H
+
+#include <vector>
+#include <atomic>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+namespace ui {
+
+/**
+ * @brief Кольцевой буфер без блокировок: один писатель, один читатель
+ *
+ * push() вызывает только поток-писатель, consume() и pop() - только
+ * поток-читатель. Индексы растут без ограничения, ячейка - индекс по
+ * маске ёмкости (степень двойки). Каждая сторона кэширует индекс
+ * другой и перечитывает его, только когда буфер кажется полным
+ * (пустым), поэтому в обычном случае push() не касается строки кэша
+ * читателя. Полный буфер отбрасывает новое значение (getDropped).
+ */
+template <class T>
+class SpscRing {
+private:
+    static constexpr size_t kCacheLine = 64;
+
+    std::vector<T> slots_;
+    size_t mask_ = 0;
+
+    // Писатель
+    alignas(kCacheLine) std::atomic<size_t> head_{0};
+    size_t cachedTail_ = 0;
+    std::atomic<uint64_t> dropped_{0};
+
+    // Читатель
+    alignas(kCacheLine) std::atomic<size_t> tail_{0};
+    size_t cachedHead_ = 0;
+
+    static size_t roundUp(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity) size <<= 1;
+        return size;
+    }
+
+public:
+    // Ёмкость округляется вверх до степени двойки
+    explicit SpscRing(size_t capacity)
+        : slots_(roundUp(capacity)), mask_(slots_.size() - 1) {}
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    // Писатель: false - буфер полон, значение отброшено
+    bool push(const T& value) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        if (head - cachedTail_ == slots_.size()) {
+            cachedTail_ = tail_.load(std::memory_order_acquire);
+            if (head - cachedTail_ == slots_.size()) {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+        }
+        slots_[head & mask_] = value;
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Читатель: передать fn(value) накопленные значения
+     * Забирает не больше max значений; место освобождается одной
+     * записью индекса после всех вызовов.
+     * @return число прочитанных значений
+     */
+    template <class Fn>
+    size_t consume(Fn fn, size_t max = SIZE_MAX) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        if (cachedHead_ == tail) {
+            cachedHead_ = head_.load(std::memory_order_acquire);
+            if (cachedHead_ == tail) return 0;
+        }
+        size_t count = std::min(cachedHead_ - tail, max);
+        for (size_t i = 0; i < count; i++) fn(slots_[(tail + i) & mask_]);
+        tail_.store(tail + count, std::memory_order_release);
+        return count;
+    }
+
+    // Читатель: одно значение; false - буфер пуст
+    bool pop(T& out) {
+        return consume([&out](const T& value) { out = value; }, 1) == 1;
+    }
+
+    // Примерное число значений (точное - только для читателя или писателя)
+    size_t size() const {
+        return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+    }
+
+    size_t capacity() const { return slots_.size(); }
+
+    // Значений отброшено из-за полного буфера
+    uint64_t getDropped() const { return dropped_.load(std::memory_order_relaxed); }
+};
+
+} // namespace ui
+
+#endif // TEXTUI_SPSCRING_H
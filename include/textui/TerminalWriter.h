@@ -0,0 +1,271 @@
+#ifndef TEXTUI_TERMINALWRITER_H
+#define TEXTUI_TERMINALWRITER_H
+
+#include "FrameEncoder.h"
+#include <vector>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include <cerrno>
+
+#ifndef _WIN32
+#include <unistd.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#endif
+
+namespace ui {
+
+/**
+ * @brief Вывод кадров в терминал из отдельного потока
+ *
+ * Поток интерфейса отдаёт готовый кадр (ячейки с литеральными
+ * стилями) в единственный слот и сразу возвращается; непринятый
+ * ещё кадр при этом заменяется новым. Писатель сравнивает кадр с
+ * последним реально отправленным и выводит разницу. Пока в очереди
+ * терминала (TIOCOUTQ) больше kMaxQueuedBytes, писатель ждёт, и
+ * промежуточные кадры пропускаются.
+ */
+class TerminalWriter {
+public:
+    static constexpr int kMaxQueuedBytes = 4096;
+    static constexpr int kBackpressureWaitMs = 5;
+
+    struct Stats {
+        uint64_t submitted = 0;
+        uint64_t written = 0;
+        uint64_t dropped = 0;     // заменены в слоте новым кадром
+        uint64_t bytes = 0;
+        double writeSeconds = 0;  // время в write() для кадров
+        int queuedBytes = 0;      // очередь терминала при последней проверке
+    };
+
+private:
+    int fd_ = 1;
+    std::thread thread_;
+    std::mutex mutex_;
+    std::condition_variable ready_;
+    bool stop_ = true;
+
+    // Слот передачи (под mutex_)
+    std::vector<ScreenCell> pending_;
+    int pendingWidth_ = 0;
+    int pendingHeight_ = 0;
+    bool hasPending_ = false;
+    std::string control_;           // служебные последовательности вне кадров
+    bool resend_ = false;           // вывести следующий кадр целиком
+    TerminalFeatures features_;
+
+    // Только поток писателя
+    std::vector<ScreenCell> frame_;
+    std::vector<ScreenCell> sent_;  // то, что уже в терминале
+    FrameEncoder encoder_;
+
+    std::atomic<uint64_t> submitted_{0};
+    std::atomic<uint64_t> written_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> bytes_{0};
+    std::atomic<uint64_t> writeNanos_{0};
+    std::atomic<int> queuedBytes_{0};
+    std::atomic<int> gapLimit_{0};
+    std::atomic<bool> parallel_{std::thread::hardware_concurrency() > 1};
+
+    int queuedBytes() const { return queuedOutputBytes(fd_); }
+
+    void writeAll(const std::string& data) {
+        if (data.empty()) return;
+#ifdef _WIN32
+        fwrite(data.data(), 1, data.size(), stdout);
+        fflush(stdout);
+#else
+        // stdin и stdout терминала делят флаги файла, а Input
+        // включает O_NONBLOCK: ждём готовности вместо EAGAIN
+        size_t done = 0;
+        while (done < data.size()) {
+            ssize_t n = ::write(fd_, data.data() + done, data.size() - done);
+            if (n > 0) {
+                done += static_cast<size_t>(n);
+            } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                struct pollfd pfd;
+                pfd.fd = fd_;
+                pfd.events = POLLOUT;
+                pfd.revents = 0;
+                ::poll(&pfd, 1, 100);
+            } else if (n < 0 && errno == EINTR) {
+                continue;
+            } else {
+                return;
+            }
+        }
+#endif
+        bytes_ += data.size();
+    }
+
+    void writeLoop() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (;;) {
+            ready_.wait(lock, [this] { return stop_ || hasPending_ || !control_.empty(); });
+            if (!hasPending_ && control_.empty()) break;   // stop_
+
+            std::string control;
+            control.swap(control_);
+            lock.unlock();
+            writeAll(control);
+
+            // Терминал не успевает: ждём, пока очередь сойдёт, а слот
+            // тем временем перезаписывается свежими кадрами
+            int queued = queuedBytes();
+            while (queued > kMaxQueuedBytes) {
+                lock.lock();
+                bool stopping = stop_;
+                lock.unlock();
+                if (stopping) break;
+                std::this_thread::sleep_for(std::chrono::milliseconds(kBackpressureWaitMs));
+                queued = queuedBytes();
+            }
+            queuedBytes_ = queued;
+
+            lock.lock();
+            if (!hasPending_) continue;
+            frame_.swap(pending_);
+            int width = pendingWidth_;
+            int height = pendingHeight_;
+            hasPending_ = false;
+            bool resend = resend_;
+            resend_ = false;
+            encoder_.setFeatures(features_);
+            lock.unlock();
+
+            ScreenCell unknown;
+            unknown.ch = '\0';
+            if (resend || sent_.size() != frame_.size()) {
+                sent_.assign(frame_.size(), unknown);
+                encoder_.invalidateCursor();
+            }
+            encoder_.setGapLimit(gapLimit_);
+            encoder_.setParallel(parallel_);
+            encoder_.begin(width);
+            encoder_.encodeDiff(frame_.data(), sent_.data(), width, height);
+            auto started = std::chrono::steady_clock::now();
+            writeAll(encoder_.finish());
+            writeNanos_ += static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - started).count());
+            written_++;
+
+            lock.lock();
+        }
+    }
+
+public:
+    // Байт в очереди вывода терминала fd (0 - пусто или неизвестно)
+    static int queuedOutputBytes(int fd) {
+#if !defined(_WIN32) && defined(TIOCOUTQ)
+        int queued = 0;
+        if (ioctl(fd, TIOCOUTQ, &queued) == 0) return queued;
+#else
+        (void)fd;
+#endif
+        return 0;
+    }
+
+    TerminalWriter() = default;
+    ~TerminalWriter() { stop(); }
+
+    TerminalWriter(const TerminalWriter&) = delete;
+    TerminalWriter& operator=(const TerminalWriter&) = delete;
+
+    /**
+     * @brief Запустить поток вывода
+     * @param shown то, что сейчас на экране (литеральные стили)
+     */
+    void start(const std::vector<ScreenCell>& shown, int fd = 1) {
+        stop();
+        fd_ = fd;
+        sent_ = shown;
+        encoder_.invalidateCursor();
+        stop_ = false;
+        thread_ = std::thread(&TerminalWriter::writeLoop, this);
+    }
+
+    // Остановить поток; принятый кадр и служебный вывод дописываются
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        ready_.notify_one();
+        if (thread_.joinable()) thread_.join();
+    }
+
+    bool isRunning() const { return thread_.joinable(); }
+
+    /**
+     * @brief Отдать кадр писателю (не ждёт вывода)
+     *
+     * Содержимое frame обменивается с буфером слота: вызывающий
+     * получает обратно память прошлого кадра для повторного
+     * использования.
+     */
+    void submit(std::vector<ScreenCell>& frame, int width, int height) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (hasPending_) dropped_++;
+            pending_.swap(frame);
+            pendingWidth_ = width;
+            pendingHeight_ = height;
+            hasPending_ = true;
+        }
+        submitted_++;
+        ready_.notify_one();
+    }
+
+    // Служебная последовательность (курсор и т.п.) перед следующим кадром
+    void sendControl(const char* sequence) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            control_.append(sequence);
+        }
+        ready_.notify_one();
+    }
+
+    // Следующий кадр вывести целиком
+    void resendAll() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        resend_ = true;
+    }
+
+    // Гранулярность разницы (FrameEncoder::setGapLimit) со следующего кадра
+    void setGapLimit(int cells) { gapLimit_ = cells; }
+
+    // Команды сжатия (FrameEncoder::setFeatures) со следующего кадра
+    void setFeatures(const TerminalFeatures& features) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        features_ = features;
+    }
+
+    // Сборка больших кадров на пуле (FrameEncoder::setParallel) со следующего кадра
+    void setParallelEncode(bool enable) { parallel_ = enable; }
+
+    // Последний отправленный кадр (после stop())
+    const std::vector<ScreenCell>& getSent() const { return sent_; }
+
+    Stats getStats() const {
+        Stats stats;
+        stats.submitted = submitted_;
+        stats.written = written_;
+        stats.dropped = dropped_;
+        stats.bytes = bytes_;
+        stats.writeSeconds = static_cast<double>(writeNanos_) * 1e-9;
+        stats.queuedBytes = queuedBytes_;
+        return stats;
+    }
+};
+
+} // namespace ui
+
+#endif // TEXTUI_TERMINALWRITER_H
@@ -0,0 +1,206 @@
+#ifndef TEXTUI_THEMEWATCHER_H
+#define TEXTUI_THEMEWATCHER_H
+
+#include "../graphics/ThemeFile.h"
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <filesystem>
+#include <thread>
+#include <functional>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+namespace ui {
+
+/**
+ * @brief Результат (пере)загрузки файла темы
+ */
+struct ThemeUpdate {
+    std::string name;    // имя в ThemeManager (имя файла без .theme)
+    std::string path;
+    bool ok = false;
+    Theme theme;         // при ok
+    std::string error;   // при !ok
+};
+
+/**
+ * @brief Слежение за каталогом файлов *.theme
+ *
+ * Чтение и разбор файлов идут в фоновом потоке; поток интерфейса
+ * только забирает готовые результаты через poll(), который
+ * никогда не ждёт. На Linux поток просыпается по inotify, на
+ * остальных системах - опросом времени изменения файлов.
+ */
+class ThemeWatcher {
+public:
+    static constexpr int kPollMs = 250;
+    static constexpr const char* kExtension = ".theme";
+
+private:
+    struct Stamp {
+        std::filesystem::file_time_type time;
+        uintmax_t size = 0;
+    };
+
+    std::string dir_;
+    std::thread thread_;
+    std::atomic<bool> stop_{true};
+
+    std::mutex mutex_;                    // защищает только pending_
+    std::vector<ThemeUpdate> pending_;
+    std::atomic<bool> hasPending_{false};
+    std::function<void()> onUpdate_;      // из фонового потока, см. setOnUpdate
+
+    std::unordered_map<std::string, Stamp> stamps_;  // только фоновый поток
+
+    void publish(ThemeUpdate update) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            pending_.push_back(std::move(update));
+            hasPending_ = true;
+        }
+        // После снятия блокировки: poll() по этому сигналу её не застанет
+        if (onUpdate_) onUpdate_();
+    }
+
+    // Перезагрузить изменившиеся файлы каталога
+    void scan() {
+        std::error_code ec;
+        std::filesystem::directory_iterator it(dir_, ec);
+        if (ec) return;
+
+        // increment(ec) вместо ++: исключение завершило бы процесс
+        for (; it != std::filesystem::directory_iterator(); it.increment(ec)) {
+            if (ec) return;
+            const std::filesystem::directory_entry& entry = *it;
+            const std::filesystem::path& path = entry.path();
+            if (path.extension() != kExtension) continue;
+            if (!entry.is_regular_file(ec)) continue;
+
+            Stamp stamp;
+            stamp.time = entry.last_write_time(ec);
+            if (ec) continue;
+            stamp.size = entry.file_size(ec);
+            if (ec) continue;
+
+            std::string key = path.string();
+            auto known = stamps_.find(key);
+            if (known != stamps_.end() && known->second.time == stamp.time &&
+                known->second.size == stamp.size) {
+                continue;
+            }
+            stamps_[key] = stamp;
+
+            ThemeUpdate update;
+            update.name = path.stem().string();
+            update.path = key;
+            update.theme.setName(update.name);
+            update.ok = ThemeFile::load(key, update.theme, update.error);
+            publish(std::move(update));
+        }
+    }
+
+    void watchLoop() {
+#ifdef __linux__
+        int inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (inotifyFd >= 0 &&
+            inotify_add_watch(inotifyFd, dir_.c_str(),
+                              IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+            ::close(inotifyFd);
+            inotifyFd = -1;
+        }
+#endif
+
+        // Файл считается готовым после закрытия на запись или
+        // переименования поверх (так сохраняют большинство редакторов)
+        scan();
+        while (!stop_) {
+#ifdef __linux__
+            if (inotifyFd >= 0) {
+                struct pollfd pfd;
+                pfd.fd = inotifyFd;
+                pfd.events = POLLIN;
+                pfd.revents = 0;
+                if (::poll(&pfd, 1, kPollMs) <= 0) continue;
+                char buffer[4096];
+                while (read(inotifyFd, buffer, sizeof(buffer)) > 0) {}
+            } else {
+                std::this_thread::sleep_for(std::chrono::milliseconds(kPollMs));
+            }
+#else
+            std::this_thread::sleep_for(std::chrono::milliseconds(kPollMs));
+#endif
+            if (!stop_) scan();
+        }
+
+#ifdef __linux__
+        if (inotifyFd >= 0) ::close(inotifyFd);
+#endif
+    }
+
+public:
+    ThemeWatcher() = default;
+    ~ThemeWatcher() { stop(); }
+
+    ThemeWatcher(const ThemeWatcher&) = delete;
+    ThemeWatcher& operator=(const ThemeWatcher&) = delete;
+
+    /**
+     * @brief Начать слежение за каталогом
+     *
+     * Уже существующие файлы загружаются фоновым потоком сразу
+     * после запуска и приходят через poll() как обычные изменения.
+     */
+    bool start(const std::string& dir) {
+        stop();
+        std::error_code ec;
+        if (!std::filesystem::is_directory(dir, ec)) return false;
+        dir_ = dir;
+        stamps_.clear();
+        stop_ = false;
+        thread_ = std::thread(&ThemeWatcher::watchLoop, this);
+        return true;
+    }
+
+    void stop() {
+        stop_ = true;
+        if (thread_.joinable()) thread_.join();
+    }
+
+    bool isRunning() const { return !stop_; }
+
+    /**
+     * @brief Сообщать о новых результатах (вызывается из фонового потока)
+     * Задаётся до start(). Подходит Wakeup::notify: цикл интерфейса
+     * спит, пока тем нечего забирать.
+     */
+    void setOnUpdate(std::function<void()> onUpdate) { onUpdate_ = std::move(onUpdate); }
+    const std::string& getDirectory() const { return dir_; }
+
+    /**
+     * @brief Забрать накопленные результаты (не блокирует)
+     * @return true, если out не пуст
+     */
+    bool poll(std::vector<ThemeUpdate>& out) {
+        out.clear();
+        if (!hasPending_) return false;
+        std::unique_lock<std::mutex> lock(mutex_, std::try_to_lock);
+        if (!lock.owns_lock()) return false;  // заберём в следующем кадре
+        out.swap(pending_);
+        hasPending_ = false;
+        return !out.empty();
+    }
+};
+
+} // namespace ui
+
+#endif // TEXTUI_THEMEWATCHER_H
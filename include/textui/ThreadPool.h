@@ -0,0 +1,177 @@
+#ifndef TEXTUI_THREADPOOL_H
+#define TEXTUI_THREADPOOL_H
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <cstddef>
+
+namespace ui {
+
+/**
+ * @brief Пул рабочих потоков для тяжёлых операций виджетов
+ *
+ * Используется для параллельного сканирования и сортировки
+ * больших списков и отрисовки окон. Задачи пула не должны сами
+ * вызывать parallelFor() и parallelEach() - ожидание внутри
+ * рабочего потока может занять весь пул.
+ */
+class ThreadPool {
+private:
+    std::vector<std::thread> workers_;
+    std::deque<std::function<void()>> tasks_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stop_ = false;
+
+    void workerLoop() {
+        for (;;) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cv_.wait(lock, [this] { return stop_ || !tasks_.empty(); });
+                if (stop_ && tasks_.empty()) return;
+                task = std::move(tasks_.front());
+                tasks_.pop_front();
+            }
+            task();
+        }
+    }
+
+public:
+    // threads = 0 - по числу ядер минус вызывающий поток
+    explicit ThreadPool(size_t threads = 0) {
+        if (threads == 0) {
+            size_t cores = std::thread::hardware_concurrency();
+            threads = cores > 1 ? cores - 1 : 1;
+        }
+        workers_.reserve(threads);
+        for (size_t i = 0; i < threads; i++) {
+            workers_.emplace_back(&ThreadPool::workerLoop, this);
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        for (auto& worker : workers_) {
+            worker.join();
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    size_t size() const { return workers_.size(); }
+
+    // Поставить задачу в очередь
+    void submit(std::function<void()> task) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            tasks_.push_back(std::move(task));
+        }
+        cv_.notify_one();
+    }
+
+    /**
+     * @brief Разбить [begin, end) на части и обработать параллельно
+     *
+     * fn(chunkBegin, chunkEnd, chunkIndex) вызывается для каждой
+     * части; первая часть выполняется в вызывающем потоке.
+     * Возвращает число частей (индексы 0..n-1).
+     */
+    template<typename Fn>
+    size_t parallelFor(size_t begin, size_t end, size_t minChunk, Fn fn) {
+        if (end <= begin) return 0;
+        size_t total = end - begin;
+        size_t chunks = std::min(size() + 1, std::max<size_t>(1, total / std::max<size_t>(1, minChunk)));
+        if (chunks == 1) {
+            fn(begin, end, size_t(0));
+            return 1;
+        }
+
+        size_t step = (total + chunks - 1) / chunks;
+        std::mutex doneMutex;
+        std::condition_variable doneCv;
+        size_t remaining = chunks - 1;
+
+        for (size_t c = 1; c < chunks; c++) {
+            size_t b = begin + c * step;
+            size_t e = std::min(end, b + step);
+            submit([&, b, e, c] {
+                if (b < e) fn(b, e, c);
+                std::lock_guard<std::mutex> lock(doneMutex);
+                if (--remaining == 0) doneCv.notify_one();
+            });
+        }
+
+        fn(begin, std::min(end, begin + step), size_t(0));
+
+        std::unique_lock<std::mutex> lock(doneMutex);
+        doneCv.wait(lock, [&] { return remaining == 0; });
+        return chunks;
+    }
+
+    /**
+     * @brief Выполнить fn(i) для каждого i из [0, count)
+     *
+     * Задачи разбираются по одной из общего счётчика: освободившийся
+     * поток сразу берёт следующую, поэтому задачи разной тяжести
+     * распределяются сами. Вызывающий поток работает наравне с пулом
+     * и ждёт только взятые задачи - занятый пул вызов не задерживает.
+     */
+    template<typename Fn>
+    void parallelEach(size_t count, Fn fn) {
+        if (count == 0) return;
+        if (count == 1) {
+            fn(size_t(0));
+            return;
+        }
+
+        // Состояние переживает вызов: опоздавший поток только
+        // увидит, что задач не осталось
+        struct State {
+            std::atomic<size_t> next{0};
+            size_t finished = 0;
+            std::mutex mutex;
+            std::condition_variable done;
+        };
+        auto state = std::make_shared<State>();
+        Fn* body = &fn;
+        auto work = [state, body, count] {
+            for (;;) {
+                size_t i = state->next.fetch_add(1);
+                if (i >= count) return;
+                (*body)(i);
+                std::lock_guard<std::mutex> lock(state->mutex);
+                if (++state->finished == count) state->done.notify_one();
+            }
+        };
+
+        size_t helpers = std::min(size(), count - 1);
+        for (size_t h = 0; h < helpers; h++) submit(work);
+        work();
+
+        std::unique_lock<std::mutex> lock(state->mutex);
+        state->done.wait(lock, [&] { return state->finished == count; });
+    }
+
+    // Общий пул библиотеки (создаётся при первом обращении)
+    static ThreadPool& shared() {
+        static ThreadPool pool;
+        return pool;
+    }
+};
+
+} // namespace ui
+
+#endif // TEXTUI_THREADPOOL_H
@@ -0,0 +1,244 @@
+#ifndef TEXTUI_TIMERWHEEL_H
+#define TEXTUI_TIMERWHEEL_H
+
+#include <array>
+#include <vector>
+#include <unordered_map>
+#include <functional>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+
+namespace ui {
+
+using TimerId = uint64_t;
+constexpr TimerId kNoTimer = 0;
+
+/**
+ * @brief Иерархическое колесо таймеров
+ *
+ * Шаг - 1 мс. Четыре уровня по 64 слота: уровень 0 хранит таймеры
+ * ближайших 64 мс, каждый следующий - в 64 раза более далёкие.
+ * Когда младший уровень проходит полный оборот, слот старшего
+ * уровня раскладывается вниз. Постановка и отмена - O(1),
+ * срабатывание - O(1) на таймер; таймеры дальше ~4.6 ч лежат в
+ * последнем слоте и перекладываются при каждом его обороте.
+ */
+class TimerWheel {
+public:
+    using Clock = std::chrono::steady_clock;
+    using Callback = std::function<void()>;
+
+    static constexpr int kLevels = 4;
+    static constexpr int kSlotBits = 6;
+    static constexpr size_t kSlots = size_t(1) << kSlotBits;
+    static constexpr uint64_t kSlotMask = kSlots - 1;
+    static constexpr uint64_t kRange = uint64_t(1) << (kSlotBits * kLevels);
+
+private:
+    struct Timer {
+        uint64_t due;        // тик срабатывания
+        uint64_t interval;   // 0 - однократный
+        Callback callback;
+    };
+
+    // В слоте - id и тик постановки; запись с устаревшим тиком
+    // (таймер отменён или переставлен) пропускается
+    struct Entry {
+        TimerId id;
+        uint64_t due;
+    };
+
+    std::array<std::array<std::vector<Entry>, kSlots>, kLevels> wheel_;
+    std::unordered_map<TimerId, Timer> timers_;
+    Clock::time_point start_;
+    uint64_t current_ = 0;     // последний обработанный тик
+    TimerId nextId_ = 1;
+
+    static uint64_t shiftOf(int level) { return static_cast<uint64_t>(kSlotBits * level); }
+
+    void insert(TimerId id, uint64_t due) {
+        uint64_t delta = due > current_ ? due - current_ : 0;
+        if (delta >= kRange) {
+            delta = kRange - 1;
+        }
+        uint64_t at = current_ + delta;
+
+        int level = 0;
+        while (level < kLevels - 1 && delta >= (uint64_t(1) << shiftOf(level + 1))) {
+            level++;
+        }
+        wheel_[level][(at >> shiftOf(level)) & kSlotMask].push_back(Entry{id, due});
+    }
+
+    // Разложить слот уровня level по младшим уровням
+    void cascade(int level) {
+        std::vector<Entry> entries;
+        entries.swap(wheel_[level][(current_ >> shiftOf(level)) & kSlotMask]);
+        for (const Entry& entry : entries) {
+            auto it = timers_.find(entry.id);
+            if (it == timers_.end() || it->second.due != entry.due) continue;
+            insert(entry.id, entry.due);
+        }
+    }
+
+    void fire(TimerId id) {
+        auto it = timers_.find(id);
+        if (it->second.interval == 0) {
+            Callback callback = std::move(it->second.callback);
+            timers_.erase(it);
+            callback();
+            return;
+        }
+
+        // Обработчик может отменить свой таймер: вызываем копию
+        // вне таблицы и возвращаем её, только если таймер жив
+        Callback callback = std::move(it->second.callback);
+        callback();
+        it = timers_.find(id);
+        if (it == timers_.end()) return;
+        Timer& timer = it->second;
+        timer.callback = std::move(callback);
+        timer.due += timer.interval;
+        if (timer.due <= current_) {
+            // Пропущенные периоды не догоняем
+            timer.due = current_ + timer.interval;
+        }
+        insert(id, timer.due);
+    }
+
+    // Следующий тик; возвращает число сработавших таймеров
+    size_t step() {
+        current_++;
+        for (int level = kLevels - 1; level > 0; level--) {
+            uint64_t mask = (uint64_t(1) << shiftOf(level)) - 1;
+            if ((current_ & mask) == 0) {
+                for (int l = level; l > 0; l--) cascade(l);
+                break;
+            }
+        }
+
+        size_t fired = 0;
+        std::vector<Entry> entries;
+        entries.swap(wheel_[0][current_ & kSlotMask]);
+        for (const Entry& entry : entries) {
+            auto it = timers_.find(entry.id);
+            if (it == timers_.end() || it->second.due != entry.due) continue;
+            if (entry.due > current_) {
+                insert(entry.id, entry.due);   // дальний таймер сделал оборот
+                continue;
+            }
+            fire(entry.id);
+            fired++;
+        }
+        return fired;
+    }
+
+    uint64_t toTick(Clock::time_point time) const {
+        if (time <= start_) return 0;
+        return static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::milliseconds>(time - start_).count());
+    }
+
+public:
+    explicit TimerWheel(Clock::time_point start = Clock::now()) : start_(start) {}
+
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    /**
+     * @brief Поставить таймер
+     * @param delayMs задержка первого срабатывания
+     * @param intervalMs период повторения (0 - однократный)
+     * @param now момент постановки: задержка отсчитывается от него, а не
+     *        от последнего обработанного тика - колесо могло простоять
+     *        без advance всё ожидание ввода
+     */
+    TimerId schedule(int delayMs, int intervalMs, Callback callback, Clock::time_point now = Clock::now()) {
+        if (delayMs < 0) delayMs = 0;
+        if (intervalMs < 0) intervalMs = 0;
+        TimerId id = nextId_++;
+        uint64_t base = std::max(current_, toTick(now));
+        uint64_t due = base + static_cast<uint64_t>(delayMs > 0 ? delayMs : 1);
+        timers_[id] = Timer{due, static_cast<uint64_t>(intervalMs), std::move(callback)};
+        insert(id, due);
+        return id;
+    }
+
+    TimerId setTimeout(int delayMs, Callback callback) {
+        return schedule(delayMs, 0, std::move(callback));
+    }
+
+    TimerId setInterval(int intervalMs, Callback callback) {
+        if (intervalMs < 1) intervalMs = 1;
+        return schedule(intervalMs, intervalMs, std::move(callback));
+    }
+
+    // Отмена; запись в слоте удалится при его обработке
+    bool cancel(TimerId id) { return timers_.erase(id) > 0; }
+
+    bool isActive(TimerId id) const { return timers_.count(id) > 0; }
+    size_t size() const { return timers_.size(); }
+    bool empty() const { return timers_.empty(); }
+
+    /**
+     * @brief Продвинуть время и выполнить наступившие таймеры
+     * @return число сработавших таймеров
+     */
+    size_t advance(Clock::time_point now = Clock::now()) {
+        uint64_t target = toTick(now);
+        size_t fired = 0;
+        while (current_ < target) {
+            if (timers_.empty()) {
+                current_ = target;
+                break;
+            }
+            fired += step();
+        }
+        return fired;
+    }
+
+    /**
+     * @brief Срок ближайшего таймера (Clock::time_point::max() - таймеров нет)
+     *
+     * На каждом уровне смотрится первый слот с живыми таймерами:
+     * слоты уровня упорядочены по времени, поэтому ближайший срок
+     * уровня лежит в нём.
+     */
+    Clock::time_point nextDeadline() const {
+        if (timers_.empty()) return Clock::time_point::max();
+
+        uint64_t best = UINT64_MAX;
+        for (int level = 0; level < kLevels; level++) {
+            uint64_t block = current_ >> shiftOf(level);
+            // Уровень 0 начинается со следующего тика, старшие - со
+            // следующего оборота (текущий слот уже разложен вниз);
+            // последний слот уровня 3 может хранить и дальние таймеры
+            for (uint64_t k = 1; k <= kSlots; k++) {
+                uint64_t slotDue = slotMinDue(wheel_[level][(block + k) & kSlotMask]);
+                if (slotDue != UINT64_MAX) {
+                    if (slotDue < best) best = slotDue;
+                    break;
+                }
+            }
+        }
+        if (best == UINT64_MAX) return Clock::time_point::max();
+        return start_ + std::chrono::milliseconds(best);
+    }
+
+private:
+    uint64_t slotMinDue(const std::vector<Entry>& slot) const {
+        uint64_t due = UINT64_MAX;
+        for (const Entry& entry : slot) {
+            auto it = timers_.find(entry.id);
+            if (it == timers_.end() || it->second.due != entry.due) continue;
+            if (entry.due < due) due = entry.due;
+        }
+        return due;
+    }
+};
+
+} // namespace ui
+
+#endif // TEXTUI_TIMERWHEEL_H
@@ -0,0 +1,494 @@
+#ifndef TEXTUI_TREEVIEW_H
+#define TEXTUI_TREEVIEW_H
+
+#include "Widget.h"
+#include "../core/Screen.h"
+#include <vector>
+#include <string>
+#include <memory>
+#include <mutex>
+#include <functional>
+#include <algorithm>
+#include <cstdint>
+
+namespace ui {
+
+// Узел, который отдаёт источник дерева
+struct TreeItem {
+    std::string text;
+    bool hasChildren = false;    // можно раскрыть (дети ещё не загружены)
+    uint64_t data = 0;           // данные вызывающего
+};
+
+/**
+ * @brief Дерево с ленивой загрузкой детей и виртуальной прокруткой
+ *
+ * Дети узла запрашиваются у источника (setProvider) при первом
+ * раскрытии. Источник отвечает вызовом reply - сразу или позже из
+ * любого потока; ответ применяется в потоке интерфейса (poll, draw,
+ * handleKey), узел до ответа помечен '~':
+ *
+ *     tree->setProvider([](int node, uint64_t data, ui::TreeView::Reply reply) {
+ *         pool.submit([=] { reply(loadChildren(data)); });   // node < 0 - корни
+ *     });
+ *     app.watch(tree, 50, [tree] { return tree->poll(); });
+ *
+ * Видимые строки - плоский список номеров узлов. Раскрытие вставляет
+ * в него видимое поддерево узла, свёртка вырезает его; хвост списка
+ * сдвигается одним перемещением памяти. Отрисовка проходит только по
+ * видимым строкам, поэтому дерево с миллионами узлов открывается
+ * сразу: загружено и развёрнуто лишь то, что раскрыл пользователь.
+ */
+class TreeView : public Widget {
+public:
+    static constexpr int kRoot = -1;   // родитель корней в запросе источника
+
+    using Reply = std::function<void(std::vector<TreeItem>)>;
+    using Provider = std::function<void(int node, uint64_t data, Reply reply)>;
+
+private:
+    struct Node {
+        std::string text;
+        uint64_t data = 0;
+        int parent = kRoot;
+        int firstChild = -1;     // дети загружаются пачкой: номера подряд
+        int childCount = 0;
+        int depth = 0;
+        bool hasChildren = false;
+        bool expanded = false;
+        bool loaded = false;
+        bool loading = false;
+    };
+
+    // Ответы источника; переживает дерево, если ответ опоздал
+    struct Inbox {
+        struct Delivery {
+            int node;
+            uint64_t generation;
+            std::vector<TreeItem> items;
+        };
+        std::mutex mutex;
+        std::vector<Delivery> ready;
+    };
+
+    std::vector<Node> nodes_;
+    std::vector<int> roots_;
+    std::vector<int> rows_;              // видимые узлы сверху вниз
+    Provider provider_;
+    std::shared_ptr<Inbox> inbox_ = std::make_shared<Inbox>();
+    std::vector<Inbox::Delivery> delivered_;
+    uint64_t generation_ = 0;            // растёт при clear(): старые ответы отбрасываются
+    bool rootsLoading_ = false;
+
+    int selectedRow_ = -1;
+    int scrollOffset_ = 0;
+    bool hasFocus_ = false;
+    std::function<void(int)> onSelect_;
+
+    void request(int node) {
+        if (!provider_) return;
+        std::shared_ptr<Inbox> inbox = inbox_;
+        uint64_t generation = generation_;
+        provider_(node, node == kRoot ? 0 : nodes_[node].data,
+                  [inbox, node, generation](std::vector<TreeItem> items) {
+                      std::lock_guard<std::mutex> lock(inbox->mutex);
+                      inbox->ready.push_back({node, generation, std::move(items)});
+                  });
+    }
+
+    // Строка узла или -1 (узел свёрнут в предке)
+    int rowOf(int node, int hint = -1) const {
+        if (hint >= 0 && hint < static_cast<int>(rows_.size()) && rows_[hint] == node) return hint;
+        auto it = std::find(rows_.begin(), rows_.end(), node);
+        return it == rows_.end() ? -1 : static_cast<int>(it - rows_.begin());
+    }
+
+    // Видимое поддерево узла (без него самого) в out
+    void collectVisible(int node, std::vector<int>& out) const {
+        const Node& parent = nodes_[node];
+        if (!parent.expanded || !parent.loaded) return;
+        for (int i = 0; i < parent.childCount; i++) {
+            int child = parent.firstChild + i;
+            out.push_back(child);
+            collectVisible(child, out);
+        }
+    }
+
+    // Число строк видимого поддерева узла в строке row
+    int subtreeRows(int row) const {
+        int depth = nodes_[rows_[row]].depth;
+        int end = row + 1;
+        while (end < static_cast<int>(rows_.size()) && nodes_[rows_[end]].depth > depth) end++;
+        return end - row - 1;
+    }
+
+    void insertRows(int row, const std::vector<int>& rows) {
+        if (rows.empty()) return;
+        rows_.insert(rows_.begin() + row, rows.begin(), rows.end());
+        if (selectedRow_ >= row) selectedRow_ += static_cast<int>(rows.size());
+    }
+
+    void eraseRows(int row, int count) {
+        if (count <= 0) return;
+        rows_.erase(rows_.begin() + row, rows_.begin() + row + count);
+        if (selectedRow_ >= row + count) {
+            selectedRow_ -= count;
+        } else if (selectedRow_ >= row) {
+            selectedRow_ = row - 1;   // выбор уходит на свёрнутый узел
+        }
+        clampScroll();
+    }
+
+    int appendNodes(int parent, std::vector<TreeItem>& items) {
+        int first = static_cast<int>(nodes_.size());
+        int depth = parent == kRoot ? 0 : nodes_[parent].depth + 1;
+        nodes_.reserve(nodes_.size() + items.size());
+        for (TreeItem& item : items) {
+            Node node;
+            node.text = std::move(item.text);
+            node.data = item.data;
+            node.parent = parent;
+            node.depth = depth;
+            node.hasChildren = item.hasChildren;
+            nodes_.push_back(std::move(node));
+        }
+        return first;
+    }
+
+    void applyDelivery(Inbox::Delivery& delivery) {
+        if (delivery.node == kRoot) {
+            rootsLoading_ = false;
+            int first = appendNodes(kRoot, delivery.items);
+            std::vector<int> added;
+            for (int i = first; i < static_cast<int>(nodes_.size()); i++) {
+                roots_.push_back(i);
+                added.push_back(i);
+            }
+            insertRows(static_cast<int>(rows_.size()), added);
+            if (selectedRow_ < 0 && !rows_.empty()) selectedRow_ = 0;
+            return;
+        }
+
+        int node = delivery.node;
+        if (node < 0 || node >= static_cast<int>(nodes_.size()) || nodes_[node].loaded) return;
+        int first = appendNodes(node, delivery.items);
+        Node& parent = nodes_[node];
+        parent.loading = false;
+        parent.loaded = true;
+        parent.firstChild = first;
+        parent.childCount = static_cast<int>(delivery.items.size());
+        if (parent.childCount == 0) {
+            parent.hasChildren = false;
+            parent.expanded = false;
+            return;
+        }
+        if (!parent.expanded) return;
+        int row = rowOf(node, selectedRow_);
+        if (row < 0) return;
+        std::vector<int> added;
+        collectVisible(node, added);
+        insertRows(row + 1, added);
+    }
+
+    void clampScroll() {
+        int maxOffset = std::max(0, getRowCount() - getVisibleCount());
+        if (scrollOffset_ > maxOffset) scrollOffset_ = maxOffset;
+        if (scrollOffset_ < 0) scrollOffset_ = 0;
+    }
+
+    void ensureRowVisible(int row) {
+        if (row < 0) return;
+        if (row < scrollOffset_) {
+            scrollOffset_ = row;
+        } else if (row >= scrollOffset_ + getVisibleCount()) {
+            scrollOffset_ = row - getVisibleCount() + 1;
+        }
+        if (scrollOffset_ < 0) scrollOffset_ = 0;
+    }
+
+    void moveToRow(int row) {
+        int rows = getRowCount();
+        if (rows == 0) return;
+        row = std::max(0, std::min(row, rows - 1));
+        bool changed = row != selectedRow_;
+        selectedRow_ = row;
+        ensureRowVisible(row);
+        if (changed && onSelect_) onSelect_(rows_[row]);
+    }
+
+public:
+    TreeView(int x, int y, int width, int height)
+        : Widget(x, y, width, height) {
+        canFocus_ = true;
+    }
+
+    /**
+     * @brief Источник детей; сразу запрашивает корни (node = kRoot)
+     * Дети каждого узла запрашиваются один раз.
+     */
+    void setProvider(Provider provider) {
+        provider_ = std::move(provider);
+        if (roots_.empty() && !rootsLoading_) {
+            rootsLoading_ = true;
+            request(kRoot);
+            poll();
+        }
+    }
+
+    // Корень без источника (дети - через источник при раскрытии)
+    int addRoot(const TreeItem& item) {
+        std::vector<TreeItem> items{item};
+        int node = appendNodes(kRoot, items);
+        roots_.push_back(node);
+        insertRows(static_cast<int>(rows_.size()), {node});
+        if (selectedRow_ < 0) selectedRow_ = 0;
+        return node;
+    }
+
+    /**
+     * @brief Применить пришедшие ответы источника (поток интерфейса)
+     * @return true - дерево изменилось
+     */
+    bool poll() {
+        {
+            std::lock_guard<std::mutex> lock(inbox_->mutex);
+            if (inbox_->ready.empty()) return false;
+            delivered_.swap(inbox_->ready);
+        }
+        bool changed = false;
+        for (Inbox::Delivery& delivery : delivered_) {
+            if (delivery.generation != generation_) continue;
+            applyDelivery(delivery);
+            changed = true;
+        }
+        delivered_.clear();
+        if (changed) clampScroll();
+        return changed;
+    }
+
+    void expand(int node) {
+        if (node < 0 || node >= static_cast<int>(nodes_.size())) return;
+        Node& target = nodes_[node];
+        if (!target.hasChildren || target.expanded) return;
+        target.expanded = true;
+        if (!target.loaded) {
+            if (!target.loading) {
+                target.loading = true;
+                request(node);
+                poll();
+            }
+            return;
+        }
+        int row = rowOf(node, selectedRow_);
+        if (row < 0) return;
+        std::vector<int> added;
+        collectVisible(node, added);
+        insertRows(row + 1, added);
+    }
+
+    void collapse(int node) {
+        if (node < 0 || node >= static_cast<int>(nodes_.size()) || !nodes_[node].expanded) return;
+        nodes_[node].expanded = false;
+        int row = rowOf(node, selectedRow_);
+        if (row >= 0) eraseRows(row + 1, subtreeRows(row));
+        if (selectedRow_ == row) ensureRowVisible(row);
+    }
+
+    void toggle(int node) {
+        if (node < 0 || node >= static_cast<int>(nodes_.size())) return;
+        if (nodes_[node].expanded) {
+            collapse(node);
+        } else {
+            expand(node);
+        }
+    }
+
+    // Удалить все узлы; ответы на прежние запросы отбрасываются
+    void clear() {
+        nodes_.clear();
+        roots_.clear();
+        rows_.clear();
+        generation_++;
+        rootsLoading_ = false;
+        selectedRow_ = -1;
+        scrollOffset_ = 0;
+    }
+
+    // Узлы
+    int getNodeCount() const { return static_cast<int>(nodes_.size()); }
+    const std::vector<int>& getRoots() const { return roots_; }
+    const std::string& getText(int node) const { return nodes_[node].text; }
+    uint64_t getData(int node) const { return nodes_[node].data; }
+    int getParent(int node) const { return nodes_[node].parent; }
+    int getDepth(int node) const { return nodes_[node].depth; }
+    bool isExpanded(int node) const { return nodes_[node].expanded; }
+    bool isLoading(int node) const { return nodes_[node].loading; }
+
+    // Загруженные дети: номера firstChild .. firstChild + count - 1
+    int getChildCount(int node) const { return nodes_[node].childCount; }
+    int getFirstChild(int node) const { return nodes_[node].firstChild; }
+
+    // Видимые строки
+    int getRowCount() const { return static_cast<int>(rows_.size()); }
+    int getRowNode(int row) const { return rows_[row]; }
+
+    int getSelectedNode() const {
+        return selectedRow_ >= 0 && selectedRow_ < getRowCount() ? rows_[selectedRow_] : -1;
+    }
+
+    // Выбрать узел (если он виден)
+    void setSelectedNode(int node) {
+        int row = rowOf(node, selectedRow_);
+        if (row < 0) return;
+        selectedRow_ = row;
+        ensureRowVisible(row);
+    }
+
+    // Смена выбора и Enter на листе
+    void setOnSelect(std::function<void(int)> callback) { onSelect_ = callback; }
+
+    bool hasFocus() const { return hasFocus_; }
+
+    void setFocused(bool focus) override {
+        focused_ = focus;
+        hasFocus_ = focus;
+    }
+
+    int getVisibleCount() const {
+        return height_ - 2;  // Учитываем рамки
+    }
+
+    bool handleKey(Key key) override {
+        if (!visible_ || !enabled_ || !hasFocus_) return false;
+        poll();
+
+        int rows = getRowCount();
+        if (rows == 0) return false;
+        int row = selectedRow_ < 0 ? 0 : selectedRow_;
+        int node = rows_[row];
+
+        switch (key) {
+            case Key::Up:
+                moveToRow(row - 1);
+                return true;
+
+            case Key::Down:
+                moveToRow(row + 1);
+                return true;
+
+            case Key::PageUp:
+                moveToRow(row - getVisibleCount());
+                return true;
+
+            case Key::PageDown:
+                moveToRow(row + getVisibleCount());
+                return true;
+
+            case Key::Home:
+                moveToRow(0);
+                return true;
+
+            case Key::End:
+                moveToRow(rows - 1);
+                return true;
+
+            // Вправо: раскрыть, у раскрытого - к первому ребёнку
+            case Key::Right:
+                if (!nodes_[node].expanded) {
+                    expand(node);
+                } else if (row + 1 < getRowCount() && nodes_[rows_[row + 1]].parent == node) {
+                    moveToRow(row + 1);
+                }
+                return true;
+
+            // Влево: свернуть, у свёрнутого - к родителю
+            case Key::Left:
+                if (nodes_[node].expanded) {
+                    collapse(node);
+                } else if (nodes_[node].parent != kRoot) {
+                    moveToRow(rowOf(nodes_[node].parent));
+                }
+                return true;
+
+            case Key::Enter:
+            case Key::Space:
+                if (nodes_[node].hasChildren) {
+                    toggle(node);
+                } else if (onSelect_) {
+                    onSelect_(node);
+                }
+                return true;
+
+            default:
+                return false;
+        }
+    }
+
+    void draw(Screen& screen) override {
+        if (!visible_) return;
+        poll();
+
+        ThemeRole normalColor = enabled_ ? ThemeRole::ListBoxNormal : ThemeRole::ListBoxDisabled;
+        ThemeRole focusColor = enabled_ ? ThemeRole::ListBoxFocused : ThemeRole::ListBoxDisabled;
+
+        screen.drawBox(x_, y_, width_, height_, BoxStyles::thin(), hasFocus_ ? focusColor : normalColor);
+
+        int visibleRows = getVisibleCount();
+        int rows = getRowCount();
+        int lineWidth = width_ - 3;  // до скроллбара
+        if (lineWidth <= 0) return;
+        std::string line;
+        for (int i = 0; i < visibleRows; i++) {
+            int row = scrollOffset_ + i;
+            if (row >= rows) {
+                screen.fillSpan(x_ + 1, y_ + 1 + i, lineWidth, ' ', normalColor);
+                continue;
+            }
+            const Node& node = nodes_[rows_[row]];
+            bool isSelected = row == selectedRow_ && hasFocus_;
+
+            // Отступ, знак раскрытия, текст
+            line.assign(1, isSelected ? Symbols::arrowRight[0] : ' ');
+            line.append(static_cast<size_t>(node.depth) * 2, ' ');
+            line.push_back(node.loading ? '~' : !node.hasChildren ? ' ' : node.expanded ? '-' : '+');
+            line.push_back(' ');
+            line.append(node.text);
+            if (static_cast<int>(line.size()) > lineWidth) {
+                line.resize(static_cast<size_t>(lineWidth - 1));
+                line.append(Symbols::arrowRight);
+            } else {
+                line.append(static_cast<size_t>(lineWidth) - line.size(), ' ');
+            }
+            screen.putString(x_ + 1, y_ + 1 + i, line, isSelected ? focusColor : normalColor);
+        }
+
+        // Скроллбар
+        if (rows > visibleRows && visibleRows > 2) {
+            int thumbSize = std::max(1, static_cast<int>(
+                static_cast<long long>(visibleRows) * visibleRows / rows));
+            int thumbPos = static_cast<int>(static_cast<long long>(scrollOffset_) *
+                (visibleRows - thumbSize) / std::max(1, rows - visibleRows));
+            int scrollX = x_ + width_ - 2;
+            for (int i = 0; i < visibleRows; i++) {
+                if (i == 0) {
+                    screen.putString(scrollX, y_ + 1 + i, Symbols::arrowUp, ThemeRole::ListBoxNormal);
+                } else if (i == visibleRows - 1) {
+                    screen.putString(scrollX, y_ + 1 + i, Symbols::arrowDown, ThemeRole::ListBoxNormal);
+                } else if (i >= thumbPos && i < thumbPos + thumbSize) {
+                    screen.putString(scrollX, y_ + 1 + i, Symbols::scrollThumb, ThemeRole::ListBoxHighlight);
+                } else {
+                    screen.putString(scrollX, y_ + 1 + i, Symbols::separatorV, ThemeRole::ListBoxNormal);
+                }
+            }
+        }
+
+        // Индикатор фокуса
+        if (hasFocus_) {
+            screen.putString(x_ - 1, y_, "#", TextStyle::biosMenu());
+        }
+    }
+};
+
+} // namespace ui
+
+#endif // TEXTUI_TREEVIEW_H
@@ -0,0 +1,94 @@
+#ifndef TEXTUI_WAKEUP_H
+#define TEXTUI_WAKEUP_H
+
+#include <atomic>
+
+#ifndef _WIN32
+#include <unistd.h>
+#include <fcntl.h>
+#endif
+
+namespace ui {
+
+/**
+ * @brief Пробуждение главного цикла из фоновых потоков
+ *
+ * notify() вызывается из любого потока, когда фоновая работа
+ * (фильтрация списка, индексация лога, перезагрузка темы) оставила
+ * результат для потока интерфейса. Ожидание ввода (Input::waitKey)
+ * слушает fd() наравне с клавиатурой и возвращается без клавиши;
+ * цикл забирает результат через consume(). Пока сигнал не забран,
+ * повторные notify() ничего не пишут. На Windows канала нет -
+ * waitKey проверяет isSignaled() между опросами клавиатуры.
+ */
+class Wakeup {
+private:
+    std::atomic<bool> signaled_{false};
+#ifndef _WIN32
+    int fds_[2] = {-1, -1};
+#endif
+
+public:
+    Wakeup() {
+#ifndef _WIN32
+        if (pipe(fds_) == 0) {
+            for (int fd : fds_) {
+                fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+                fcntl(fd, F_SETFD, FD_CLOEXEC);
+            }
+        } else {
+            fds_[0] = fds_[1] = -1;
+        }
+#endif
+    }
+
+    ~Wakeup() {
+#ifndef _WIN32
+        for (int fd : fds_) {
+            if (fd >= 0) ::close(fd);
+        }
+#endif
+    }
+
+    Wakeup(const Wakeup&) = delete;
+    Wakeup& operator=(const Wakeup&) = delete;
+
+    // Разбудить ожидание (любой поток)
+    void notify() {
+        if (signaled_.exchange(true)) return;
+#ifndef _WIN32
+        if (fds_[1] >= 0) {
+            char byte = 1;
+            ssize_t n = ::write(fds_[1], &byte, 1);
+            (void)n;   // канал полон - ожидание и так проснётся
+        }
+#endif
+    }
+
+    bool isSignaled() const { return signaled_; }
+
+    /**
+     * @brief Забрать сигнал (поток интерфейса)
+     * Канал очищается до сброса флага: notify() между ними не пишет,
+     * но его результат уже виден проверкам, которые идут после consume().
+     * @return true, если после прошлого вызова был notify()
+     */
+    bool consume() {
+        if (!signaled_) return false;
+#ifndef _WIN32
+        char buffer[64];
+        while (fds_[0] >= 0 && ::read(fds_[0], buffer, sizeof(buffer)) > 0) {}
+#endif
+        signaled_ = false;
+        return true;
+    }
+
+#ifndef _WIN32
+    // Конец канала для select/poll (-1 - канал не создан)
+    int fd() const { return fds_[0]; }
+#endif
+};
+
+} // namespace ui
+
+#endif // TEXTUI_WAKEUP_H
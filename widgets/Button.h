@@ -60,9 +60,9 @@ public:
     void draw(Screen& screen) override {
         if (!visible_) return;
 
-        ColorAttr normalColor = enabled_ ? ColorAttr::normal() : ColorAttr::biosDisabled();
-        ColorAttr focusColor = enabled_ ? ColorAttr::highlight() : ColorAttr::biosDisabled();
-        ColorAttr color = hasFocus_ ? focusColor : normalColor;
+        ThemeRole normalColor = enabled_ ? ThemeRole::ButtonNormal : ThemeRole::ButtonDisabled;
+        ThemeRole focusColor = enabled_ ? ThemeRole::ButtonFocused : ThemeRole::ButtonDisabled;
+        ThemeRole color = hasFocus_ ? focusColor : normalColor;
 
         // Р Р°РјРєР°
         screen.drawBox(x_, y_, width_, height_, BoxStyles::thin(), color);
@@ -81,9 +81,9 @@ public:
             
             if (hotkeyPos != std::string::npos && !hasFocus_) {
                 // РџРѕРєР°Р·С‹РІР°РµРј РіРѕСЂСЏС‡СѓСЋ РєР»Р°РІРёС€Сѓ РѕС‚РґРµР»СЊРЅРѕ
-                screen.putString(x_ + 1, y_, "[", TextStyle::biosHotkey());
-                screen.putString(x_ + 2, y_, std::string(1, static_cast<char>(toupper(hotkey_))).c_str(), TextStyle::biosHotkey());
-                screen.putString(x_ + 3, y_, "]", TextStyle::biosHotkey());
+                screen.putString(x_ + 1, y_, "[", ThemeRole::Hotkey);
+                screen.putString(x_ + 2, y_, std::string(1, static_cast<char>(toupper(hotkey_))).c_str(), ThemeRole::Hotkey);
+                screen.putString(x_ + 3, y_, "]", ThemeRole::Hotkey);
                 btnText = " " + text_ + " ";
             } else {
                 btnText = " " + text_ + " ";
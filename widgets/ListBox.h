@@ -2,9 +2,12 @@
 #define TEXTUI_LISTBOX_H
 
 #include "Widget.h"
+#include "ItemFilter.h"
 #include "../core/Screen.h"
 #include <vector>
+#include <string>
 #include <functional>
+#include <algorithm>
 
 namespace ui {
 
@@ -22,6 +25,42 @@ private:
     std::function<void(int)> onDoubleClick_;
     bool showScrollBars_ = true;
     int lastClickTime_ = 0;
+    ItemFilter filter_;            // РїРѕСЃР»Рµ items_: Р·Р°РґР°РЅРёРµ С‡РёС‚Р°РµС‚ СЃРїРёСЃРѕРє
+    bool typeToFilter_ = false;
+
+    // РџСЂРѕРєСЂСѓС‚РєР° С‚Р°Рє, С‡С‚РѕР±С‹ СЃС‚СЂРѕРєР° Р±С‹Р»Р° РІРёРґРЅР°
+    void ensureRowVisible(int row) {
+        if (row < 0) return;
+        if (row < scrollOffset_) {
+            scrollOffset_ = row;
+        } else if (row >= scrollOffset_ + getVisibleCount()) {
+            scrollOffset_ = row - getVisibleCount() + 1;
+        }
+        if (scrollOffset_ < 0) scrollOffset_ = 0;
+    }
+
+    // Р’С‹Р±РѕСЂ РІРёРґРёРјРѕР№ СЃС‚СЂРѕРєРё СЃ РѕРіСЂР°РЅРёС‡РµРЅРёРµРј РїРѕ РґРёР°РїР°Р·РѕРЅСѓ
+    void moveToRow(int row) {
+        int rows = getRowCount();
+        if (rows == 0) return;
+        row = std::max(0, std::min(row, rows - 1));
+        int item = filter_.rowToItem(row);
+        bool changed = item != selectedIndex_;
+        selectedIndex_ = item;
+        ensureRowVisible(row);
+        if (changed && onSelect_) onSelect_(selectedIndex_);
+    }
+
+    // РЎРѕРіР»Р°СЃРѕРІР°С‚СЊ РІС‹Р±РѕСЂ Рё РїСЂРѕРєСЂСѓС‚РєСѓ СЃ РЅРѕРІС‹Рј РЅР°Р±РѕСЂРѕРј СЃС‚СЂРѕРє
+    void syncWithFilter() {
+        int rows = getRowCount();
+        if (rows > 0 && filter_.itemToRow(selectedIndex_) < 0) {
+            selectedIndex_ = filter_.rowToItem(0);
+        }
+        int maxOffset = std::max(0, rows - getVisibleCount());
+        if (scrollOffset_ > maxOffset) scrollOffset_ = maxOffset;
+        ensureRowVisible(filter_.itemToRow(selectedIndex_));
+    }
 
 public:
     ListBox(int x, int y, int width, int height)
@@ -29,28 +68,52 @@ public:
         canFocus_ = true;
     }
 
+    /**
+     * @brief Р—Р°Р±СЂР°С‚СЊ СЂРµР·СѓР»СЊС‚Р°С‚ С„РѕРЅРѕРІРѕР№ С„РёР»СЊС‚СЂР°С†РёРё
+     * Р’С‹Р·С‹РІР°РµС‚СЃСЏ РёР· draw/handleKey; App, РєСЂРѕРјРµ С‚РѕРіРѕ, Р·Р°Р±РёСЂР°РµС‚ РµРіРѕ РІ
+     * РєР°РґСЂРµ, РєРѕС‚РѕСЂС‹Р№ Р±СѓРґРёС‚ setOnFilterReady, - Р±РµР· РЅР°Р¶Р°С‚РёСЏ РєР»Р°РІРёС€Рё.
+     * @return true - РЅР°Р±РѕСЂ РІРёРґРёРјС‹С… СЃС‚СЂРѕРє РёР·РјРµРЅРёР»СЃСЏ
+     */
+    bool pollFilter() {
+        if (!filter_.poll(items_)) return false;
+        syncWithFilter();
+        return true;
+    }
+
+    // Р¤РѕРЅРѕРІР°СЏ С„РёР»СЊС‚СЂР°С†РёСЏ Р·Р°РєРѕРЅС‡РёР»Р°СЃСЊ (РІС‹Р·С‹РІР°РµС‚СЃСЏ РёР· РµС‘ РїРѕС‚РѕРєР°), СЃРј. ItemFilter::setOnReady
+    void setOnFilterReady(std::function<void()> onReady) { filter_.setOnReady(std::move(onReady)); }
+
     void setShowScrollBars(bool show) { showScrollBars_ = show; }
 
     // Р”РѕР±Р°РІР»РµРЅРёРµ СЌР»РµРјРµРЅС‚Р°
     void addItem(const std::string& item, void* data = nullptr) {
+        filter_.prepareAppend(items_);
         items_.push_back(item);
         itemData_.push_back(data);
+        filter_.itemAppended(items_);
         if (selectedIndex_ < 0) selectedIndex_ = 0;
+        if (filter_.active()) syncWithFilter();
     }
 
     void insertItem(int index, const std::string& item, void* data = nullptr) {
         if (index < 0 || index > static_cast<int>(items_.size())) return;
+        filter_.cancel();
         items_.insert(items_.begin() + index, item);
         itemData_.insert(itemData_.begin() + index, data);
         if (selectedIndex_ >= index) selectedIndex_++;
+        filter_.refresh(items_);
+        syncWithFilter();
     }
 
     void removeItem(int index) {
         if (index < 0 || index >= static_cast<int>(items_.size())) return;
+        filter_.cancel();
         items_.erase(items_.begin() + index);
         itemData_.erase(itemData_.begin() + index);
         if (selectedIndex_ >= index) selectedIndex_--;
         if (selectedIndex_ < 0 && !items_.empty()) selectedIndex_ = 0;
+        filter_.refresh(items_);
+        syncWithFilter();
     }
 
     void removeItem(const std::string& item) {
@@ -63,10 +126,12 @@ public:
     }
 
     void clearItems() {
+        filter_.cancel();
         items_.clear();
         itemData_.clear();
         selectedIndex_ = -1;
         scrollOffset_ = 0;
+        filter_.refresh(items_);
     }
 
     int getCount() const { return static_cast<int>(items_.size()); }
@@ -76,12 +141,7 @@ public:
     void setSelectedIndex(int index) {
         if (index >= 0 && index < static_cast<int>(items_.size())) {
             selectedIndex_ = index;
-            // РџСЂРѕРєСЂСѓС‚РєР° Рє РІС‹Р±СЂР°РЅРЅРѕРјСѓ СЌР»РµРјРµРЅС‚Сѓ
-            if (selectedIndex_ < scrollOffset_) {
-                scrollOffset_ = selectedIndex_;
-            } else if (selectedIndex_ >= scrollOffset_ + getVisibleCount()) {
-                scrollOffset_ = selectedIndex_ - getVisibleCount() + 1;
-            }
+            ensureRowVisible(filter_.itemToRow(index));
         }
     }
 
@@ -116,6 +176,27 @@ public:
         onDoubleClick_ = callback;
     }
 
+    // Р¤РёР»СЊС‚СЂ РїРѕ РїРѕРґСЃС‚СЂРѕРєРµ (Р±РµР· СѓС‡С‘С‚Р° СЂРµРіРёСЃС‚СЂР°)
+    void setFilter(const std::string& query) {
+        filter_.setQuery(items_, query);
+        syncWithFilter();
+    }
+
+    const std::string& getFilter() const { return filter_.query(); }
+    void clearFilter() { setFilter(""); }
+
+    // Р¤РёР»СЊС‚СЂР°С†РёСЏ РµС‰С‘ РёРґС‘С‚ РІ С„РѕРЅРµ
+    bool isFilterPending() const { return filter_.pending(); }
+
+    // Р РµР¶РёРј "РЅР°Р±РµСЂРё РґР»СЏ РїРѕРёСЃРєР°": РїРµС‡Р°С‚РЅС‹Рµ СЃРёРјРІРѕР»С‹ СѓС‚РѕС‡РЅСЏСЋС‚ С„РёР»СЊС‚СЂ
+    void setTypeToFilter(bool enable) { typeToFilter_ = enable; }
+    bool isTypeToFilter() const { return typeToFilter_; }
+
+    bool wantsTextInput() const override { return typeToFilter_ && hasFocus_; }
+
+    // Р§РёСЃР»Рѕ РІРёРґРёРјС‹С… (РїСЂРѕС€РµРґС€РёС… С„РёР»СЊС‚СЂ) СЃС‚СЂРѕРє
+    int getRowCount() const { return filter_.rowCount(static_cast<int>(items_.size())); }
+
     bool hasFocus() const { return hasFocus_; }
 
     void setFocused(bool focus) override {
@@ -128,62 +209,61 @@ public:
     }
 
     bool handleKey(Key key) override {
-        if (!visible_ || !enabled_ || !hasFocus_ || items_.empty()) return false;
+        if (!visible_ || !enabled_ || !hasFocus_) return false;
+        pollFilter();
+
+        // Р’РІРѕРґ Р·Р°РїСЂРѕСЃР° С„РёР»СЊС‚СЂР°
+        if (typeToFilter_) {
+            if (key == Key::Backspace) {
+                if (filter_.active()) {
+                    std::string query = filter_.query();
+                    query.pop_back();
+                    setFilter(query);
+                }
+                return true;
+            }
+            if (key == Key::Escape && filter_.active()) {
+                clearFilter();
+                return true;
+            }
+            if (key >= Key::Space && key < Key::Up) {
+                setFilter(filter_.query() + static_cast<char>(static_cast<int>(key)));
+                return true;
+            }
+        }
+
+        int rows = getRowCount();
+        if (rows == 0) return false;
+        int row = filter_.itemToRow(selectedIndex_);
 
         switch (key) {
             case Key::Up:
-                if (selectedIndex_ > 0) {
-                    selectedIndex_--;
-                    if (selectedIndex_ < scrollOffset_) {
-                        scrollOffset_ = selectedIndex_;
-                    }
-                    if (onSelect_) onSelect_(selectedIndex_);
-                }
+                moveToRow(row < 0 ? 0 : row - 1);
                 return true;
 
             case Key::Down:
-                if (selectedIndex_ < static_cast<int>(items_.size()) - 1) {
-                    selectedIndex_++;
-                    if (selectedIndex_ >= scrollOffset_ + getVisibleCount()) {
-                        scrollOffset_ = selectedIndex_ - getVisibleCount() + 1;
-                    }
-                    if (onSelect_) onSelect_(selectedIndex_);
-                }
+                moveToRow(row + 1);
                 return true;
 
             case Key::PageUp:
-                selectedIndex_ -= getVisibleCount();
-                if (selectedIndex_ < 0) selectedIndex_ = 0;
-                scrollOffset_ = selectedIndex_;
-                if (onSelect_) onSelect_(selectedIndex_);
+                moveToRow(row - getVisibleCount());
                 return true;
 
             case Key::PageDown:
-                selectedIndex_ += getVisibleCount();
-                if (selectedIndex_ >= static_cast<int>(items_.size())) {
-                    selectedIndex_ = static_cast<int>(items_.size()) - 1;
-                }
-                scrollOffset_ = selectedIndex_ - getVisibleCount() + 1;
-                if (scrollOffset_ < 0) scrollOffset_ = 0;
-                if (onSelect_) onSelect_(selectedIndex_);
+                moveToRow(row + getVisibleCount());
                 return true;
 
             case Key::Home:
-                selectedIndex_ = 0;
-                scrollOffset_ = 0;
-                if (onSelect_) onSelect_(selectedIndex_);
+                moveToRow(0);
                 return true;
 
             case Key::End:
-                selectedIndex_ = static_cast<int>(items_.size()) - 1;
-                scrollOffset_ = selectedIndex_ - getVisibleCount() + 1;
-                if (scrollOffset_ < 0) scrollOffset_ = 0;
-                if (onSelect_) onSelect_(selectedIndex_);
+                moveToRow(rows - 1);
                 return true;
 
             case Key::Enter:
             case Key::Space:
-                if (onSelect_) onSelect_(selectedIndex_);
+                if (row >= 0 && onSelect_) onSelect_(selectedIndex_);
                 return true;
 
             default:
@@ -193,17 +273,25 @@ public:
 
     void draw(Screen& screen) override {
         if (!visible_) return;
+        pollFilter();
 
-        ColorAttr normalColor = enabled_ ? ColorAttr::normal() : ColorAttr::biosDisabled();
-        ColorAttr focusColor = enabled_ ? ColorAttr::highlight() : ColorAttr::biosDisabled();
+        ThemeRole normalColor = enabled_ ? ThemeRole::ListBoxNormal : ThemeRole::ListBoxDisabled;
+        ThemeRole focusColor = enabled_ ? ThemeRole::ListBoxFocused : ThemeRole::ListBoxDisabled;
 
         // Р Р°РјРєР°
         screen.drawBox(x_, y_, width_, height_, BoxStyles::thin(), hasFocus_ ? focusColor : normalColor);
 
         // Р РёСЃСѓРµРј СЌР»РµРјРµРЅС‚С‹
         int visibleItems = getVisibleCount();
-        for (int i = 0; i < visibleItems && scrollOffset_ + i < static_cast<int>(items_.size()); i++) {
-            int itemIndex = scrollOffset_ + i;
+        int rows = getRowCount();
+        int lineWidth = width_ - 3;  // РґРѕ СЃРєСЂРѕР»Р»Р±Р°СЂР°
+        for (int i = 0; i < visibleItems; i++) {
+            if (scrollOffset_ + i >= rows) {
+                // РџСѓСЃС‚С‹Рµ СЃС‚СЂРѕРєРё Р·Р°С‚РёСЂР°РµРј - СЃРїРёСЃРѕРє РјРѕРі СЃРѕРєСЂР°С‚РёС‚СЊСЃСЏ С„РёР»СЊС‚СЂРѕРј
+                screen.putString(x_ + 1, y_ + 1 + i, std::string(std::max(0, lineWidth), ' '), normalColor);
+                continue;
+            }
+            int itemIndex = filter_.rowToItem(scrollOffset_ + i);
             std::string display = items_[itemIndex];
             bool isSelected = (itemIndex == selectedIndex_);
 
@@ -220,18 +308,33 @@ public:
             } else {
                 line = " " + display;
             }
+            if (static_cast<int>(line.length()) < lineWidth) {
+                line.append(lineWidth - line.length(), ' ');
+            }
 
             // Р¦РІРµС‚
-            ColorAttr color = (isSelected && hasFocus_) ? focusColor : normalColor;
+            ThemeRole color = (isSelected && hasFocus_) ? focusColor : normalColor;
             
             screen.putString(x_ + 1, y_ + 1 + i, line.c_str(), color);
         }
 
         // РЎРєСЂРѕР»Р»Р±Р°СЂ (РµСЃР»Рё РІРєР»СЋС‡РµРЅ)
-        if (showScrollBars_ && static_cast<int>(items_.size()) > visibleItems) {
+        if (showScrollBars_ && rows > visibleItems) {
             drawScrollBar(screen);
         }
 
+        // РЎС‚СЂРѕРєР° С„РёР»СЊС‚СЂР° РІ РЅРёР¶РЅРµР№ СЂР°РјРєРµ
+        if (filter_.active()) {
+            std::string query = "/" + filter_.query() + (filter_.pending() ? "..." : "");
+            int maxLen = width_ - 4;
+            if (maxLen > 0 && static_cast<int>(query.length()) > maxLen) {
+                query = query.substr(query.length() - maxLen);
+            }
+            if (maxLen > 0) {
+                screen.putString(x_ + 2, y_ + height_ - 1, query, hasFocus_ ? focusColor : normalColor);
+            }
+        }
+
         // РРЅРґРёРєР°С‚РѕСЂ С„РѕРєСѓСЃР°
         if (hasFocus_) {
             screen.putString(x_ - 1, y_, "#", TextStyle::biosMenu());
@@ -241,7 +344,7 @@ public:
 private:
     void drawScrollBar(Screen& screen) {
         int visibleItems = getVisibleCount();
-        int totalItems = static_cast<int>(items_.size());
+        int totalItems = getRowCount();
         
         // РџРѕР·РёС†РёСЏ Рё СЂР°Р·РјРµСЂ РїРѕР»Р·СѓРЅРєР°
         int thumbSize = std::max(1, (visibleItems * visibleItems) / totalItems);
@@ -252,13 +355,13 @@ private:
         int scrollX = x_ + width_ - 2;
         for (int i = 0; i < visibleItems; i++) {
             if (i == 0) {
-                screen.putString(scrollX, y_ + 1 + i, Symbols::arrowUp, ColorAttr::normal());
+                screen.putString(scrollX, y_ + 1 + i, Symbols::arrowUp, ThemeRole::ListBoxNormal);
             } else if (i == visibleItems - 1) {
-                screen.putString(scrollX, y_ + 1 + i, Symbols::arrowDown, ColorAttr::normal());
+                screen.putString(scrollX, y_ + 1 + i, Symbols::arrowDown, ThemeRole::ListBoxNormal);
             } else if (i >= thumbPos && i < thumbPos + thumbSize) {
-                screen.putString(scrollX, y_ + 1 + i, Symbols::scrollThumb, ColorAttr::highlight());
+                screen.putString(scrollX, y_ + 1 + i, Symbols::scrollThumb, ThemeRole::ListBoxHighlight);
             } else {
-                screen.putString(scrollX, y_ + 1 + i, Symbols::separatorV, ColorAttr::normal());
+                screen.putString(scrollX, y_ + 1 + i, Symbols::separatorV, ThemeRole::ListBoxNormal);
             }
         }
     }
@@ -0,0 +1,577 @@
+#ifndef TEXTUI_LOGVIEW_H
+#define TEXTUI_LOGVIEW_H
+
+#include "Widget.h"
+#include "../core/Screen.h"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define TEXTUI_LOGVIEW_SSE2 1
+#endif
+
+#ifdef _WIN32
+#include <windows.h>
+#include <intrin.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <poll.h>
+#endif
+#endif
+
+namespace ui {
+
+/**
+ * @brief Файл, отображённый в память (только чтение)
+ *
+ * Отображение пересоздаётся при росте файла. Указатель data()
+ * действителен до следующего вызова map() или close().
+ */
+class MappedFile {
+private:
+#ifdef _WIN32
+    HANDLE hFile_ = INVALID_HANDLE_VALUE;
+    HANDLE hMapping_ = nullptr;
+#else
+    int fd_ = -1;
+#endif
+    const char* data_ = nullptr;
+    uint64_t size_ = 0;
+
+    void unmap() {
+        if (!data_) return;
+#ifdef _WIN32
+        UnmapViewOfFile(data_);
+        if (hMapping_) CloseHandle(hMapping_);
+        hMapping_ = nullptr;
+#else
+        munmap(const_cast<char*>(data_), static_cast<size_t>(size_));
+#endif
+        data_ = nullptr;
+        size_ = 0;
+    }
+
+public:
+    MappedFile() = default;
+    ~MappedFile() { close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& path) {
+        close();
+#ifdef _WIN32
+        hFile_ = CreateFileA(path.c_str(), GENERIC_READ,
+                             FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                             nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        return hFile_ != INVALID_HANDLE_VALUE;
+#else
+        fd_ = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        return fd_ >= 0;
+#endif
+    }
+
+    void close() {
+        unmap();
+#ifdef _WIN32
+        if (hFile_ != INVALID_HANDLE_VALUE) CloseHandle(hFile_);
+        hFile_ = INVALID_HANDLE_VALUE;
+#else
+        if (fd_ >= 0) ::close(fd_);
+        fd_ = -1;
+#endif
+    }
+
+    bool isOpen() const {
+#ifdef _WIN32
+        return hFile_ != INVALID_HANDLE_VALUE;
+#else
+        return fd_ >= 0;
+#endif
+    }
+
+    // Текущий размер файла на диске
+    uint64_t fileSize() const {
+#ifdef _WIN32
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(hFile_, &size)) return 0;
+        return static_cast<uint64_t>(size.QuadPart);
+#else
+        struct stat st;
+        if (fstat(fd_, &st) != 0) return 0;
+        return static_cast<uint64_t>(st.st_size);
+#endif
+    }
+
+    // Отобразить первые size байт файла
+    bool map(uint64_t size) {
+        unmap();
+        if (size == 0) return true;
+#ifdef _WIN32
+        hMapping_ = CreateFileMappingA(hFile_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!hMapping_) return false;
+        void* view = MapViewOfFile(hMapping_, FILE_MAP_READ, 0, 0, static_cast<SIZE_T>(size));
+        if (!view) {
+            CloseHandle(hMapping_);
+            hMapping_ = nullptr;
+            return false;
+        }
+        data_ = static_cast<const char*>(view);
+#else
+        void* view = mmap(nullptr, static_cast<size_t>(size), PROT_READ, MAP_SHARED, fd_, 0);
+        if (view == MAP_FAILED) return false;
+        madvise(view, static_cast<size_t>(size), MADV_SEQUENTIAL);
+        data_ = static_cast<const char*>(view);
+#endif
+        size_ = size;
+        return true;
+    }
+
+    const char* data() const { return data_; }
+    uint64_t size() const { return size_; }
+
+#ifndef _WIN32
+    int fd() const { return fd_; }
+#endif
+};
+
+/**
+ * @brief Просмотр больших лог-файлов
+ *
+ * Файл отображается в память, индекс начал строк строится
+ * фоновым потоком по частям, поэтому первый экран рисуется
+ * до окончания индексации. Строки не копируются: отрисовка
+ * читает их прямо из отображения через std::string_view.
+ * В режиме слежения (follow) дописанные в файл строки
+ * подхватываются через inotify (или опросом размера).
+ *
+ * Усечение файла на месте (copytruncate) обрабатывается
+ * переиндексацией, но между усечением и её началом чтение
+ * за новым концом файла может привести к SIGBUS.
+ */
+class LogView : public Widget {
+private:
+    // Индекс строк хранится блоками, чтобы дописывание
+    // не перемещало уже построенную часть
+    static constexpr size_t kBlockBits = 16;
+    static constexpr size_t kBlockSize = size_t(1) << kBlockBits;
+    static constexpr uint64_t kScanChunk = 4u << 20;  // 4 МБ за проход
+    static constexpr int kPollMs = 200;
+
+    std::string path_;
+    MappedFile file_;
+    std::vector<std::unique_ptr<uint64_t[]>> blocks_;  // начала строк
+    size_t lineStarts_ = 0;
+    uint64_t indexedBytes_ = 0;
+    bool indexComplete_ = false;
+
+    mutable std::mutex mutex_;
+    std::thread indexer_;
+    std::atomic<bool> stop_{false};
+    std::function<void()> onChange_;   // копия уходит потоку индексации в open()
+
+    size_t scrollOffset_ = 0;
+    size_t hScroll_ = 0;
+    bool follow_ = false;
+    bool hasFocus_ = false;
+
+    // Индекс на момент последней отрисовки (под mutex_), см. changed()
+    size_t drawnLines_ = 0;
+    uint64_t drawnBytes_ = 0;
+    bool drawnComplete_ = false;
+
+    // Начало строки по номеру (под mutex_)
+    uint64_t lineStart(size_t i) const {
+        return blocks_[i >> kBlockBits][i & (kBlockSize - 1)];
+    }
+
+    void appendStarts(const std::vector<uint64_t>& starts) {
+        for (uint64_t pos : starts) {
+            if ((lineStarts_ & (kBlockSize - 1)) == 0) {
+                blocks_.push_back(std::unique_ptr<uint64_t[]>(new uint64_t[kBlockSize]));
+            }
+            blocks_.back()[lineStarts_ & (kBlockSize - 1)] = pos;
+            lineStarts_++;
+        }
+    }
+
+    // Число строк (под mutex_): незавершённая последняя строка
+    // показывается только когда индексация дошла до конца файла
+    size_t lineCountLocked() const {
+        if (lineStarts_ == 0) return 0;
+        size_t count = lineStarts_ - 1;
+        if (indexComplete_ && lineStart(lineStarts_ - 1) < indexedBytes_) count++;
+        return count;
+    }
+
+    // Строка без перевода строки (под mutex_)
+    std::string_view lineLocked(size_t i) const {
+        uint64_t begin = lineStart(i);
+        uint64_t end = (i + 1 < lineStarts_) ? lineStart(i + 1) - 1 : indexedBytes_;
+        if (end > begin && file_.data()[end - 1] == '\r') end--;
+        return std::string_view(file_.data() + begin, static_cast<size_t>(end - begin));
+    }
+
+    static unsigned lowestBit(unsigned mask) {
+#ifdef _MSC_VER
+        unsigned long idx;
+        _BitScanForward(&idx, mask);
+        return static_cast<unsigned>(idx);
+#else
+        return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+    }
+
+    void indexLoop(const std::function<void()>& onChange);
+    bool waitForChange(uint64_t knownSize);
+
+public:
+    LogView(int x, int y, int width, int height)
+        : Widget(x, y, width, height) {
+        canFocus_ = true;
+    }
+
+    ~LogView() override { close(); }
+
+    // Поиск переводов строк в [begin, end), в out попадают начала следующих строк
+    static void scanNewlines(const char* data, uint64_t begin, uint64_t end,
+                             std::vector<uint64_t>& out) {
+        uint64_t i = begin;
+#ifdef TEXTUI_LOGVIEW_SSE2
+        const __m128i newline = _mm_set1_epi8('\n');
+        for (; i + 16 <= end; i += 16) {
+            __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+            unsigned mask = static_cast<unsigned>(
+                _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, newline)));
+            while (mask) {
+                out.push_back(i + lowestBit(mask) + 1);
+                mask &= mask - 1;
+            }
+        }
+#endif
+        for (; i < end; i++) {
+            if (data[i] == '\n') out.push_back(i + 1);
+        }
+    }
+
+    // Открыть файл и запустить индексацию
+    bool open(const std::string& path) {
+        close();
+        if (!file_.open(path)) return false;
+        path_ = path;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            appendStarts({0});
+        }
+        stop_ = false;
+        indexer_ = std::thread([this, onChange = onChange_] { indexLoop(onChange); });
+        return true;
+    }
+
+    void close() {
+        stop_ = true;
+        if (indexer_.joinable()) indexer_.join();
+        std::lock_guard<std::mutex> lock(mutex_);
+        file_.close();
+        blocks_.clear();
+        lineStarts_ = 0;
+        indexedBytes_ = 0;
+        indexComplete_ = false;
+        scrollOffset_ = 0;
+        hScroll_ = 0;
+    }
+
+    const std::string& getPath() const { return path_; }
+
+    // Следить за дописыванием в конец файла
+    void setFollow(bool follow) { follow_ = follow; }
+    bool isFollowing() const { return follow_; }
+
+    size_t getLineCount() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return lineCountLocked();
+    }
+
+    // Копия строки (string_view из отображения наружу не отдаём)
+    std::string getLine(size_t index) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (index >= lineCountLocked()) return std::string();
+        return std::string(lineLocked(index));
+    }
+
+    /**
+     * @brief Сообщать о росте индекса (вызывается из потока индексации)
+     *
+     * Срабатывает после каждой части индексации и после дописывания
+     * в файл; действует с ближайшего open(). Подходит Wakeup::notify:
+     * App::addLogView так будит цикл, чтобы хвост и процент обновлялись
+     * без опроса по таймеру.
+     */
+    void setOnChange(std::function<void()> onChange) { onChange_ = std::move(onChange); }
+
+    /**
+     * @brief Индекс изменился после последней отрисовки
+     *
+     * Индексация и дописывание идут в фоновом потоке, сам виджет
+     * перерисовку не запрашивает; владелец проверяет changed() после
+     * сигнала setOnChange (или по таймеру) и перерисовывает виджет.
+     */
+    bool changed() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return lineStarts_ != drawnLines_ || indexedBytes_ != drawnBytes_ ||
+               indexComplete_ != drawnComplete_;
+    }
+
+    bool isIndexing() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return file_.isOpen() && !indexComplete_;
+    }
+
+    uint64_t getIndexedBytes() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return indexedBytes_;
+    }
+
+    uint64_t getFileSize() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return file_.size();
+    }
+
+    int getVisibleCount() const {
+        return height_ - 2;  // Учитываем рамки
+    }
+
+    void scrollToLine(size_t line) {
+        size_t count = getLineCount();
+        size_t visible = static_cast<size_t>(std::max(1, getVisibleCount()));
+        size_t maxOffset = count > visible ? count - visible : 0;
+        scrollOffset_ = std::min(line, maxOffset);
+        follow_ = false;
+    }
+
+    size_t getScrollOffset() const { return scrollOffset_; }
+
+    bool hasFocus() const { return hasFocus_; }
+
+    void setFocused(bool focus) override {
+        focused_ = focus;
+        hasFocus_ = focus;
+    }
+
+    bool handleKey(Key key) override {
+        if (!visible_ || !enabled_ || !hasFocus_) return false;
+
+        size_t page = static_cast<size_t>(std::max(1, getVisibleCount()));
+
+        switch (key) {
+            case Key::Up:
+                if (scrollOffset_ > 0) scrollToLine(scrollOffset_ - 1);
+                return true;
+
+            case Key::Down:
+                scrollToLine(scrollOffset_ + 1);
+                return true;
+
+            case Key::PageUp:
+                scrollToLine(scrollOffset_ > page ? scrollOffset_ - page : 0);
+                return true;
+
+            case Key::PageDown:
+                scrollToLine(scrollOffset_ + page);
+                return true;
+
+            case Key::Home:
+                scrollToLine(0);
+                return true;
+
+            case Key::End:
+                // End включает слежение за хвостом файла
+                follow_ = true;
+                return true;
+
+            case Key::Left:
+                if (hScroll_ > 0) hScroll_--;
+                return true;
+
+            case Key::Right:
+                hScroll_++;
+                return true;
+
+            default:
+                return false;
+        }
+    }
+
+    void draw(Screen& screen) override {
+        if (!visible_) return;
+
+        ThemeRole normalColor = enabled_ ? ThemeRole::ListBoxNormal : ThemeRole::ListBoxDisabled;
+        ThemeRole focusColor = enabled_ ? ThemeRole::ListBoxFocused : ThemeRole::ListBoxDisabled;
+
+        // Рамка
+        screen.drawBox(x_, y_, width_, height_, BoxStyles::thin(), hasFocus_ ? focusColor : normalColor);
+
+        int visibleRows = getVisibleCount();
+        int innerWidth = width_ - 2;
+        if (visibleRows <= 0 || innerWidth <= 0) return;
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        size_t count = lineCountLocked();
+        drawnLines_ = lineStarts_;
+        drawnBytes_ = indexedBytes_;
+        drawnComplete_ = indexComplete_;
+
+        // В режиме слежения держим хвост на экране
+        size_t maxOffset = count > static_cast<size_t>(visibleRows)
+                         ? count - static_cast<size_t>(visibleRows) : 0;
+        if (follow_ || scrollOffset_ > maxOffset) {
+            scrollOffset_ = maxOffset;
+        }
+
+        StyleId style = roleStyleId(normalColor);
+        for (int row = 0; row < visibleRows; row++) {
+            size_t index = scrollOffset_ + static_cast<size_t>(row);
+            std::string_view line = index < count ? lineLocked(index) : std::string_view();
+            if (hScroll_ < line.size()) {
+                line.remove_prefix(hScroll_);
+            } else {
+                line = std::string_view();
+            }
+
+            int cx = x_ + 1;
+            for (int i = 0; i < innerWidth; i++) {
+                char ch = i < static_cast<int>(line.size()) ? line[i] : ' ';
+                // Управляющие символы ломают позиционирование курсора
+                if (static_cast<unsigned char>(ch) < 32) ch = ' ';
+                screen.putChar(cx + i, y_ + 1 + row, ch, style);
+            }
+        }
+
+        // Статус индексации в нижней рамке
+        std::string status = " " + std::to_string(count) + " lines";
+        if (!indexComplete_ && file_.size() > 0) {
+            status += ", " + std::to_string(indexedBytes_ * 100 / file_.size()) + "%";
+        }
+        if (follow_) status += ", follow";
+        status += " ";
+        if (static_cast<int>(status.length()) < innerWidth) {
+            screen.putString(x_ + width_ - 1 - static_cast<int>(status.length()),
+                             y_ + height_ - 1, status.c_str(), normalColor);
+        }
+    }
+};
+
+// Фоновая индексация: сначала весь текущий файл, затем
+// ожидание дописывания и индексация хвоста
+inline void LogView::indexLoop(const std::function<void()>& onChange) {
+    std::vector<uint64_t> starts;
+    uint64_t knownSize = file_.fileSize();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!file_.map(knownSize)) knownSize = 0;
+    }
+
+    while (!stop_) {
+        uint64_t pos = indexedBytes_;  // пишется только этим потоком
+        uint64_t mapped = file_.size();
+
+        while (pos < mapped && !stop_) {
+            uint64_t end = std::min(mapped, pos + kScanChunk);
+            starts.clear();
+            scanNewlines(file_.data(), pos, end, starts);
+            pos = end;
+
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                appendStarts(starts);
+                indexedBytes_ = pos;
+            }
+            if (onChange) onChange();
+        }
+        if (stop_) break;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            indexComplete_ = true;
+        }
+        if (onChange) onChange();
+
+        if (!waitForChange(knownSize)) continue;
+
+        uint64_t newSize = file_.fileSize();
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (newSize < indexedBytes_) {
+            // Файл усечён (ротация на месте) - индексируем заново
+            blocks_.clear();
+            lineStarts_ = 0;
+            appendStarts({0});
+            indexedBytes_ = 0;
+        }
+        if (newSize != file_.size() && !file_.map(newSize)) {
+            indexedBytes_ = 0;
+            blocks_.clear();
+            lineStarts_ = 0;
+            appendStarts({0});
+            newSize = 0;
+        }
+        knownSize = newSize;
+        indexComplete_ = indexedBytes_ >= newSize;
+    }
+}
+
+// Ожидание изменения размера файла (true - размер изменился)
+inline bool LogView::waitForChange(uint64_t knownSize) {
+#ifdef __linux__
+    int inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotifyFd >= 0 &&
+        inotify_add_watch(inotifyFd, path_.c_str(), IN_MODIFY | IN_ATTRIB | IN_CLOSE_WRITE) < 0) {
+        ::close(inotifyFd);
+        inotifyFd = -1;
+    }
+#endif
+
+    bool changed = false;
+    while (!stop_ && !changed) {
+#ifdef __linux__
+        if (inotifyFd >= 0) {
+            struct pollfd pfd;
+            pfd.fd = inotifyFd;
+            pfd.events = POLLIN;
+            pfd.revents = 0;
+            if (poll(&pfd, 1, kPollMs) > 0) {
+                char buffer[4096];
+                while (read(inotifyFd, buffer, sizeof(buffer)) > 0) {}
+            }
+        } else {
+            std::this_thread::sleep_for(std::chrono::milliseconds(kPollMs));
+        }
+#else
+        std::this_thread::sleep_for(std::chrono::milliseconds(kPollMs));
+#endif
+        changed = file_.fileSize() != knownSize;
+    }
+
+#ifdef __linux__
+    if (inotifyFd >= 0) ::close(inotifyFd);
+#endif
+    return changed;
+}
+
+} // namespace ui
+
+#endif // TEXTUI_LOGVIEW_H
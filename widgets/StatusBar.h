@@ -29,20 +29,20 @@ struct StatusItem {
 class StatusBar : public Widget {
 private:
     std::vector<StatusItem> items_;
-    ColorAttr normalColor_;
-    ColorAttr highlightColor_;
+    StyleId normalColor_;
+    StyleId highlightColor_;
 
 public:
     StatusBar(int x, int y, int width)
         : Widget(x, y, width, 1) {
         canFocus_ = false;
-        normalColor_ = ColorAttr(Color8::Black, Color8::Gray);
-        highlightColor_ = ColorAttr(Color8::BrightWhite, Color8::Blue);
+        normalColor_ = roleStyleId(ThemeRole::StatusBarNormal);
+        highlightColor_ = roleStyleId(ThemeRole::StatusBarHighlight);
     }
 
     void setColors(ColorAttr normal, ColorAttr highlight) {
-        normalColor_ = normal;
-        highlightColor_ = highlight;
+        normalColor_ = normal.styleId();
+        highlightColor_ = highlight.styleId();
     }
 
     // Р”РѕР±Р°РІР»РµРЅРёРµ СЌР»РµРјРµРЅС‚Р°
@@ -126,7 +126,7 @@ public:
         }
 
         // Р Р°РјРєР° СЃРІРµСЂС…Сѓ
-        screen.drawHLine(x_, y_, width_, Symbols::separatorH, ColorAttr::normal());
+        screen.drawHLine(x_, y_, width_, Symbols::separatorH, ThemeRole::StatusBarText);
     }
 };
 
@@ -2,6 +2,7 @@
 #define TEXTUI_TABCONTROL_H
 
 #include "Widget.h"
+#include "HotkeyTable.h"
 #include "../core/Screen.h"
 #include <vector>
 #include <string>
@@ -13,21 +14,26 @@ namespace ui {
 /**
  * @brief Р’РєР»Р°РґРєР° (СЃС‚СЂР°РЅРёС†Р°) РІ TabControl
  */
-class TabPage {
+class TabPage : public HotkeyScope {
 private:
     std::string name_;
     std::vector<std::unique_ptr<Widget>> widgets_;
     char hotkey_ = '\0';
     bool visible_ = false;
+    Widget* owner_ = nullptr;      // TabControl, РєРѕС‚РѕСЂРѕРјСѓ РїСЂРёРЅР°РґР»РµР¶РёС‚ РІРєР»Р°РґРєР°
+    HotkeyTable hotkeys_;
 
 public:
-    TabPage(const std::string& name) : name_(name) {}
+    TabPage(const std::string& name, Widget* owner = nullptr) : name_(name), owner_(owner) {}
 
     const std::string& getName() const { return name_; }
     void setName(const std::string& name) { name_ = name; }
     
     char getHotkey() const { return hotkey_; }
-    void setHotkey(char key) { hotkey_ = key; }
+    void setHotkey(char key) {
+        hotkey_ = key;
+        if (owner_) owner_->notifyHotkeysChanged();
+    }
     
     bool isVisible() const { return visible_; }
     void setVisible(bool v) { visible_ = v; }
@@ -38,10 +44,19 @@ public:
         auto widget = std::make_unique<T>(x, y, std::forward<Args>(args)...);
         T* ptr = widget.get();
         widgets_.push_back(std::move(widget));
+        ptr->setHotkeyScope(this);
+        hotkeys_.update(ptr);
         return ptr;
     }
 
     // РћС‚СЂРёСЃРѕРІРєР° РІСЃРµС… РІРёРґР¶РµС‚РѕРІ СЃС‚СЂР°РЅРёС†С‹
+    bool canDrawConcurrently() const {
+        for (const auto& widget : widgets_) {
+            if (!widget->canDrawConcurrently()) return false;
+        }
+        return true;
+    }
+
     void draw(Screen& screen) {
         if (!visible_) return;
         for (auto& widget : widgets_) {
@@ -67,14 +82,12 @@ public:
     // РћР±СЂР°Р±РѕС‚РєР° РіРѕСЂСЏС‡РёС… РєР»Р°РІРёС€
     bool handleHotkey(char key) {
         if (!visible_) return false;
-        for (auto& widget : widgets_) {
-            if (widget->visible() && widget->handleHotkey(key)) {
-                return true;
-            }
-        }
-        return false;
+        Widget* target = hotkeys_.find(key);
+        return target && target->handleHotkey(key);
     }
 
+    void hotkeysChanged(Widget* widget) override { hotkeys_.update(widget); }
+
     // РџРµСЂРµРєР»СЋС‡РµРЅРёРµ С„РѕРєСѓСЃР° РјРµР¶РґСѓ РІРёРґР¶РµС‚Р°РјРё
     void focusNext() {
         if (widgets_.empty()) return;
@@ -149,7 +162,7 @@ public:
 
     // Р”РѕР±Р°РІР»РµРЅРёРµ РІРєР»Р°РґРєРё
     TabPage* addTab(const std::string& name) {
-        auto tab = std::make_unique<TabPage>(name);
+        auto tab = std::make_unique<TabPage>(name, this);
         TabPage* ptr = tab.get();
         tabs_.push_back(std::move(tab));
         if (tabs_.size() == 1) {
@@ -188,6 +201,13 @@ public:
         onTabChange_ = callback;
     }
 
+    bool canDrawConcurrently() const override {
+        for (const auto& tab : tabs_) {
+            if (!tab->canDrawConcurrently()) return false;
+        }
+        return true;
+    }
+
     bool handleKey(Key key) override {
         if (!visible_ || !enabled_) return false;
 
@@ -219,6 +239,16 @@ public:
         return false;
     }
 
+    // Р‘СѓРєРІС‹ РІРєР»Р°РґРѕРє; РєР»Р°РІРёС€Рё РІРёРґР¶РµС‚РѕРІ СЃС‚СЂР°РЅРёС†С‹ РѕР±СЂР°Р±Р°С‚С‹РІР°СЋС‚СЃСЏ С‡РµСЂРµР· С„РѕРєСѓСЃ
+    size_t getHotkeys(char* out, size_t max) const override {
+        size_t count = 0;
+        for (const auto& tab : tabs_) {
+            if (count == max) break;
+            if (tab->getHotkey() != '\0') out[count++] = tab->getHotkey();
+        }
+        return count;
+    }
+
     bool handleHotkey(char key) override {
         if (!visible_ || !enabled_) return false;
 
@@ -272,14 +302,14 @@ public:
                 tabText = " " + name + " ";
             }
 
-            ColorAttr color;
+            ThemeRole color;
             if (isSelected) {
-                color = ColorAttr::biosSelected();
+                color = ThemeRole::TabFocused;
                 // Р РёСЃСѓРµРј Р°РєС‚РёРІРЅСѓСЋ РІРєР»Р°РґРєСѓ
                 screen.fillRect(tabX - 1, tabY, static_cast<int>(tabText.length()) + 2, 1, ' ', color);
                 screen.putString(tabX, tabY, tabText.c_str(), color);
             } else {
-                color = enabled_ ? ColorAttr::biosMenu() : ColorAttr::biosDisabled();
+                color = enabled_ ? ThemeRole::TabNormal : ThemeRole::TabDisabled;
                 screen.putString(tabX, tabY, tabText.c_str(), color);
             }
 
@@ -287,7 +317,7 @@ public:
         }
 
         // Р РёСЃСѓРµРј СЂР°Р·РґРµР»РёС‚РµР»СЊ РїРѕРґ РІРєР»Р°РґРєР°РјРё
-        screen.drawHLine(x_, y_ + 1, width_, Symbols::separatorH, ColorAttr::normal());
+        screen.drawHLine(x_, y_ + 1, width_, Symbols::separatorH, ThemeRole::TabText);
 
         // Р РёСЃСѓРµРј СЃРѕРґРµСЂР¶РёРјРѕРµ С‚РµРєСѓС‰РµР№ РІРєР»Р°РґРєРё
         if (selectedIndex_ >= 0 && selectedIndex_ < static_cast<int>(tabs_.size())) {
@@ -295,7 +325,7 @@ public:
         }
 
         // Р Р°РјРєР° РІРѕРєСЂСѓРі СЃРѕРґРµСЂР¶РёРјРѕРіРѕ
-        screen.drawBox(x_, y_ + 1, width_, height_ - 1, BoxStyles::thin(), ColorAttr::normal());
+        screen.drawBox(x_, y_ + 1, width_, height_ - 1, BoxStyles::thin(), ThemeRole::TabText);
     }
 };
 
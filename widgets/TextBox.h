@@ -161,6 +161,8 @@ public:
 
     bool hasFocus() const { return hasFocus_; }
 
+    bool wantsTextInput() const override { return hasFocus_; }
+
     void setFocused(bool focus) override {
         focused_ = focus;
         hasFocus_ = focus;
@@ -335,9 +337,9 @@ public:
     void draw(Screen& screen) override {
         if (!visible_) return;
 
-        ColorAttr normalColor = enabled_ ? ColorAttr::normal() : ColorAttr::biosDisabled();
-        ColorAttr focusColor = enabled_ ? ColorAttr::highlight() : ColorAttr::biosDisabled();
-        ColorAttr color = hasFocus_ ? focusColor : normalColor;
+        ThemeRole normalColor = enabled_ ? ThemeRole::TextBoxNormal : ThemeRole::TextBoxDisabled;
+        ThemeRole focusColor = enabled_ ? ThemeRole::TextBoxFocused : ThemeRole::TextBoxDisabled;
+        ThemeRole color = hasFocus_ ? focusColor : normalColor;
 
         // Р Р°РјРєР°
         screen.drawBox(x_, y_, width_, height_, BoxStyles::thin(), color);
@@ -348,7 +350,7 @@ public:
         // Placeholder РµСЃР»Рё РїСѓСЃС‚Рѕ
         if (display.empty() && !placeholder_.empty() && !hasFocus_) {
             display = placeholder_;
-            color = ColorAttr(Color8::Gray, Color8::Black);
+            color = ThemeRole::TextBoxDisabled;
         }
 
         // РџСЂРѕРєСЂСѓС‚РєР°
@@ -376,7 +378,7 @@ public:
             std::string hotkeyText = "[";
             hotkeyText += static_cast<char>(toupper(hotkey_));
             hotkeyText += "]";
-            screen.putString(x_, y_, hotkeyText.c_str(), TextStyle::biosHotkey());
+            screen.putString(x_, y_, hotkeyText.c_str(), ThemeRole::Hotkey);
         }
 
         // РРЅРґРёРєР°С‚РѕСЂ РјРѕРґРёС„РёРєР°С†РёРё
@@ -11,6 +11,19 @@
 
 namespace ui {
 
+class Widget;
+
+/**
+ * @brief РћР±Р»Р°СЃС‚СЊ СЂРµРіРёСЃС‚СЂР°С†РёРё РіРѕСЂСЏС‡РёС… РєР»Р°РІРёС€ (РѕРєРЅРѕ, СЃС‚СЂР°РЅРёС†Р° РІРєР»Р°РґРєРё)
+ */
+class HotkeyScope {
+public:
+    virtual ~HotkeyScope() = default;
+
+    // РљР»Р°РІРёС€Рё, РІРёРґРёРјРѕСЃС‚СЊ РёР»Рё РґРѕСЃС‚СѓРїРЅРѕСЃС‚СЊ РІРёРґР¶РµС‚Р° РёР·РјРµРЅРёР»РёСЃСЊ
+    virtual void hotkeysChanged(Widget* widget) = 0;
+};
+
 /**
  * @brief Р‘Р°Р·РѕРІС‹Р№ РєР»Р°СЃСЃ РІСЃРµС… РІРёРґР¶РµС‚РѕРІ
  */
@@ -28,6 +41,7 @@ protected:
     TextStyle style_;
     std::string tooltip_;
     char hotkey_ = '\0';  // Р“РѕСЂСЏС‡Р°СЏ РєР»Р°РІРёС€Р° (Alt+X)
+    HotkeyScope* hotkeyScope_ = nullptr;  // РѕР±Р»Р°СЃС‚СЊ, РіРґРµ Р·Р°СЂРµРіРёСЃС‚СЂРёСЂРѕРІР°РЅ РІРёРґР¶РµС‚
 
 public:
     Widget(int x, int y, int w, int h)
@@ -51,14 +65,26 @@ public:
     // РЎРµС‚С‚РµСЂС‹
     void setPosition(int x, int y) { x_ = x; y_ = y; }
     void setSize(int w, int h) { width_ = w; height_ = h; }
-    void setVisible(bool v) { visible_ = v; }
-    void setEnabled(bool v) { enabled_ = v; }
+    void setVisible(bool v) {
+        if (visible_ == v) return;
+        visible_ = v;
+        notifyHotkeysChanged();
+    }
+    void setEnabled(bool v) {
+        if (enabled_ == v) return;
+        enabled_ = v;
+        notifyHotkeysChanged();
+    }
     virtual void setFocused(bool v) { focused_ = v; }
     void setFocus(bool v) { focused_ = v; }  // РђР»РёР°СЃ РґР»СЏ СЃРѕРІРјРµСЃС‚РёРјРѕСЃС‚Рё
     void setCanFocus(bool v) { canFocus_ = v; }
     void setText(const std::string& t) { text_ = t; }
     void setTooltip(const std::string& t) { tooltip_ = t; }
-    void setHotkey(char key) { hotkey_ = key; }
+    void setHotkey(char key) {
+        if (hotkey_ == key) return;
+        hotkey_ = key;
+        notifyHotkeysChanged();
+    }
     void setStyle(const TextStyle& s) { style_ = s; }
 
     // РџСЂРѕРІРµСЂРєР° РїРѕРїР°РґР°РЅРёСЏ С‚РѕС‡РєРё
@@ -80,8 +106,47 @@ public:
         return false;
     }
 
+    // РљР»Р°РІРёС€Рё, РЅР° РєРѕС‚РѕСЂС‹Рµ РѕС‚РІРµС‡Р°РµС‚ handleHotkey (РґР»СЏ С‚Р°Р±Р»РёС†С‹ РѕР±Р»Р°СЃС‚Рё)
+    virtual size_t getHotkeys(char* out, size_t max) const {
+        if (hotkey_ == '\0' || max == 0) return 0;
+        out[0] = hotkey_;
+        return 1;
+    }
+
+    void setHotkeyScope(HotkeyScope* scope) { hotkeyScope_ = scope; }
+    HotkeyScope* getHotkeyScope() const { return hotkeyScope_; }
+
+    // РЎРѕРѕР±С‰РёС‚СЊ РѕР±Р»Р°СЃС‚Рё, С‡С‚Рѕ РЅР°Р±РѕСЂ РєР»Р°РІРёС€ РІРёРґР¶РµС‚Р° РёР·РјРµРЅРёР»СЃСЏ
+    void notifyHotkeysChanged() {
+        if (hotkeyScope_) hotkeyScope_->hotkeysChanged(this);
+    }
+
+    // Р’РёРґР¶РµС‚ РїСЂРёРЅРёРјР°РµС‚ С‚РµРєСЃС‚РѕРІС‹Р№ РІРІРѕРґ: Р±СѓРєРІС‹ РЅРµ СЃС‡РёС‚Р°СЋС‚СЃСЏ РіРѕСЂСЏС‡РёРјРё РєР»Р°РІРёС€Р°РјРё
+    virtual bool wantsTextInput() const { return false; }
+
+    /**
+     * @brief РњРѕР¶РЅРѕ Р»Рё СЂРёСЃРѕРІР°С‚СЊ РІРёРґР¶РµС‚ РІ СЂР°Р±РѕС‡РµРј РїРѕС‚РѕРєРµ (App::setParallelDraw)
+     *
+     * РћРєРЅР° СЂРёСЃСѓСЋС‚СЃСЏ РїР°СЂР°Р»Р»РµР»СЊРЅРѕ, РєР°Р¶РґРѕРµ РІ СЃРІРѕС‘Рј СЃР»РѕРµ. draw() С‚Р°РєРѕРіРѕ
+     * РІРёРґР¶РµС‚Р° РјРµРЅСЏРµС‚ С‚РѕР»СЊРєРѕ СЃРѕСЃС‚РѕСЏРЅРёРµ СЃР°РјРѕРіРѕ РІРёРґР¶РµС‚Р°, РїРёС€РµС‚ С‚РѕР»СЊРєРѕ РІ
+     * РїРµСЂРµРґР°РЅРЅС‹Р№ Screen Рё РЅРµ РІС‹С…РѕРґРёС‚ Р·Р° РїСЂСЏРјРѕСѓРіРѕР»СЊРЅРёРє СЃРІРѕРµРіРѕ РѕРєРЅР°
+     * (Р·Р° РµРіРѕ РїСЂРµРґРµР»Р°РјРё СЃР»РѕР№ РѕР±СЂРµР·Р°РµС‚СЃСЏ); РЅРµ РІС‹Р·С‹РІР°РµС‚ App, РѕР±СЂР°Р±РѕС‚С‡РёРєРё
+     * Рё ThreadPool. Р’СЃС‚СЂРѕРµРЅРЅС‹Рµ РІРёРґР¶РµС‚С‹ СЌС‚Рѕ СЃРѕР±Р»СЋРґР°СЋС‚, РєСЂРѕРјРµ СЂР°СЃРєСЂС‹С‚РѕРіРѕ
+     * DropDown. РРЅР°С‡Рµ - РІРµСЂРЅСѓС‚СЊ false: РѕРєРЅРѕ РЅР°СЂРёСЃСѓРµС‚СЃСЏ РІ РїРѕС‚РѕРєРµ
+     * РёРЅС‚РµСЂС„РµР№СЃР°.
+     */
+    virtual bool canDrawConcurrently() const { return true; }
+
     // РћС‚СЂРёСЃРѕРІРєР°
     virtual void draw(Screen& screen) = 0;
+
+    /**
+     * @brief РџРµСЂРµСЂРёСЃРѕРІРєР° РїРѕСЃР»Рµ App::invalidate(widget)
+     *
+     * РџРѕРґ РІРёРґР¶РµС‚РѕРј РѕСЃС‚Р°Р»СЃСЏ РµРіРѕ РїСЂРѕС€Р»С‹Р№ РєР°РґСЂ (РѕРєРЅРѕ РЅРµ РїРµСЂРµСЂРёСЃРѕРІС‹РІР°Р»РѕСЃСЊ),
+     * РїРѕСЌС‚РѕРјСѓ РґРѕСЃС‚Р°С‚РѕС‡РЅРѕ РІС‹РІРµСЃС‚Рё С‚Рѕ, С‡С‚Рѕ РёР·РјРµРЅРёР»РѕСЃСЊ. РџРѕ СѓРјРѕР»С‡Р°РЅРёСЋ - draw().
+     */
+    virtual void drawChanges(Screen& screen) { draw(screen); }
     
     // РџРѕР»СѓС‡РёС‚СЊ РїСЂРµРґРїРѕС‡С‚РёС‚РµР»СЊРЅСѓСЋ РІС‹СЃРѕС‚Сѓ
     virtual int getPreferredHeight() const { return height_; }
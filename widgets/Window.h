@@ -2,17 +2,19 @@
 #define TEXTUI_WINDOW_H
 
 #include "Widget.h"
+#include "HotkeyTable.h"
 #include "../core/Screen.h"
 #include <vector>
 #include <memory>
 #include <string>
+#include <algorithm>
 
 namespace ui {
 
 /**
  * @brief РћРєРЅРѕ СЃ Р·Р°РіРѕР»РѕРІРєРѕРј Рё СЂР°РјРєРѕР№
  */
-class Window : public Widget {
+class Window : public Widget, public HotkeyScope {
 private:
     std::string title_;
     std::vector<std::unique_ptr<Widget>> children_;
@@ -20,16 +22,17 @@ private:
     bool modal_ = false;
     bool draggable_ = false;
     bool hasCloseButton_ = false;
-    ColorAttr titleColor_;
-    ColorAttr borderColor_;
+    StyleId titleColor_;
+    StyleId borderColor_;
     BoxStyle boxStyle_;
+    HotkeyTable hotkeys_;
 
 public:
     Window(int x, int y, int w, int h, const std::string& title = "")
         : Widget(x, y, w, h)
         , title_(title)
-        , titleColor_(ColorAttr::biosTitle())
-        , borderColor_(ColorAttr::biosMenu())
+        , titleColor_(roleStyleId(ThemeRole::WindowTitle))
+        , borderColor_(roleStyleId(ThemeRole::WindowBorder))
         , boxStyle_(BoxStyles::doubleLine()) {
         canFocus_ = true;
     }
@@ -46,8 +49,8 @@ public:
     void setShowCloseButton(bool v) { hasCloseButton_ = v; }
     bool hasCloseButton() const { return hasCloseButton_; }
 
-    void setTitleColor(ColorAttr c) { titleColor_ = c; }
-    void setBorderColor(ColorAttr c) { borderColor_ = c; }
+    void setTitleColor(ColorAttr c) { titleColor_ = c.styleId(); }
+    void setBorderColor(ColorAttr c) { borderColor_ = c.styleId(); }
     void setBoxStyle(const BoxStyle& style) { boxStyle_ = style; }
 
     // Р”РѕР±Р°РІР»РµРЅРёРµ РґРѕС‡РµСЂРЅРµРіРѕ РІРёРґР¶РµС‚Р°
@@ -56,11 +59,32 @@ public:
         auto widget = std::make_unique<T>(std::forward<Args>(args)...);
         T* ptr = widget.get();
         children_.push_back(std::move(widget));
+        ptr->setHotkeyScope(this);
+        hotkeys_.update(ptr);
         return ptr;
     }
 
+    bool hasChild(const Widget* child) const {
+        for (const auto& widget : children_) {
+            if (widget.get() == child) return true;
+        }
+        return false;
+    }
+
+    // РЈРґР°Р»РµРЅРёРµ РґРѕС‡РµСЂРЅРµРіРѕ РІРёРґР¶РµС‚Р°
+    bool removeChild(Widget* child) {
+        auto it = std::find_if(children_.begin(), children_.end(),
+                               [child](const std::unique_ptr<Widget>& w) { return w.get() == child; });
+        if (it == children_.end()) return false;
+        hotkeys_.remove(child);
+        if (focusedChild_ == child) focusedChild_ = nullptr;
+        children_.erase(it);
+        return true;
+    }
+
     // РЈРґР°Р»РµРЅРёРµ РІСЃРµС… РґРѕС‡РµСЂРЅРёС… РІРёРґР¶РµС‚РѕРІ
     void clearChildren() {
+        hotkeys_.clear();
         children_.clear();
         focusedChild_ = nullptr;
     }
@@ -75,6 +99,8 @@ public:
 
     size_t getChildCount() const { return children_.size(); }
 
+    Widget* getFocusedChild() const { return focusedChild_; }
+
     // Р¤РѕРєСѓСЃ РЅР° РїРµСЂРІС‹Р№ РґРѕСЃС‚СѓРїРЅС‹Р№ РІРёРґР¶РµС‚
     void focusFirst() {
         for (auto& child : children_) {
@@ -134,6 +160,17 @@ public:
         }
     }
 
+    bool wantsTextInput() const override {
+        return focusedChild_ && focusedChild_->wantsTextInput();
+    }
+
+    bool canDrawConcurrently() const override {
+        for (const auto& child : children_) {
+            if (!child->canDrawConcurrently()) return false;
+        }
+        return true;
+    }
+
     // РћР±СЂР°Р±РѕС‚РєР° РєР»Р°РІРёР°С‚СѓСЂС‹
     bool handleKey(Key key) override {
         if (!visible_ || !enabled_) return false;
@@ -162,14 +199,23 @@ public:
     bool handleHotkey(char key) override {
         if (!visible_ || !enabled_) return false;
 
-        // РЎРЅР°С‡Р°Р»Р° РїС‹С‚Р°РµРјСЃСЏ РїРµСЂРµРґР°С‚СЊ РіРѕСЂСЏС‡СѓСЋ РєР»Р°РІРёС€Сѓ РґРѕС‡РµСЂРЅРёРј РІРёРґР¶РµС‚Р°Рј
-        for (auto& child : children_) {
-            if (child->visible() && child->handleHotkey(key)) {
-                return true;
-            }
+        // РЎРЅР°С‡Р°Р»Р° РІРёРґР¶РµС‚ СЃ С„РѕРєСѓСЃРѕРј (РІР»РѕР¶РµРЅРЅС‹Рµ РѕР±Р»Р°СЃС‚Рё, РЅР°РїСЂРёРјРµСЂ РІРєР»Р°РґРєРё),
+        // Р·Р°С‚РµРј РІР»Р°РґРµР»РµС† РєР»Р°РІРёС€Рё РїРѕ С‚Р°Р±Р»РёС†Рµ РѕРєРЅР°
+        if (focusedChild_ && focusedChild_->handleHotkey(key)) {
+            return true;
         }
+        Widget* target = hotkeys_.find(key);
+        return target && target != focusedChild_ && target->handleHotkey(key);
+    }
 
-        return false;
+    void hotkeysChanged(Widget* widget) override { hotkeys_.update(widget); }
+
+    // Р’Р»Р°РґРµР»РµС† РіРѕСЂСЏС‡РµР№ РєР»Р°РІРёС€Рё РІ РѕРєРЅРµ (nullptr - РЅРµС‚)
+    Widget* findHotkey(char key) const { return hotkeys_.find(key); }
+
+    // РЈРІРµРґРѕРјР»РµРЅРёРµ Рѕ РєРѕРЅС„Р»РёРєС‚Р°С… РіРѕСЂСЏС‡РёС… РєР»Р°РІРёС€ РїСЂРё СЂРµРіРёСЃС‚СЂР°С†РёРё
+    void setOnHotkeyConflict(HotkeyTable::ConflictHandler handler) {
+        hotkeys_.setOnConflict(std::move(handler));
     }
 
     void setFocused(bool focus) override {